@@ -3,11 +3,19 @@
 
 #include "GUI.h"
 #include "Core/Input/Input.h"
+#include "Core/Profiling/Profiler.h"
+#include "Core/Threading/JobSystem.h"
 #include "Game/World/ChunkManager.h"
+#include "Game/World/ChunkMesher.h"
 #include "Game/World/Generator/ChunkGenerator.h"
 #include "MineClone/Core/Event/ApplicationEvents.h"
+#include "MineClone/Core/Renderer/DeletionQueue.h"
+#include "MineClone/Core/Renderer/GeometryArena.h"
+#include "MineClone/Core/Renderer/MemoryAllocator.h"
 #include "MineClone/Core/Renderer/RendererAPI.h"
 #include "MineClone/Core/Renderer/RendererTypes.h"
+#include "MineClone/Core/Renderer/StagingRing.h"
+#include "MineClone/Core/Renderer/VulkanTypes.h"
 
 namespace mc
 {
@@ -31,6 +39,7 @@ namespace mc
         Init();
 
         while(m_isRunning) {
+            Profiler::BeginFrame();
             Update();
 
             RendererAPI::BeginFrame(m_deltaTime, m_player->GetCamera());
@@ -40,6 +49,12 @@ namespace mc
             RenderGUI();
             GUI::EndFrame();
             RendererAPI::EndFrame();
+
+            if(m_timeToFirstFrame == 0) {
+                using namespace std::chrono;
+                m_timeToFirstFrame = duration<f32, milliseconds::period>(high_resolution_clock::now() - m_startTimePoint).count();
+                std::cout << std::format("First frame submitted after {:.1f} ms\n", m_timeToFirstFrame);
+            }
         }
         
         Cleanup();
@@ -51,19 +66,40 @@ namespace mc
 
         RendererAPI::Init();
         GUI::Init();
+        JobSystem::Init();
+
+        Ref<Material> blockIndicatorMaterial;
+        {
+            using namespace std::chrono;
+            auto start = high_resolution_clock::now();
+
+            VertexDescription meshDescription = Vertex3D::GetDescription();
+            VertexDescription chunkDescription = ChunkVertex::GetDescription();
+            std::array<Material::CreateInfo, 3> createInfos = {{
+                {"default", meshDescription},
+                {"chunk", chunkDescription},
+                {"Block Indicator", meshDescription},
+            }};
+
+            std::vector<Ref<Material>> materials = Material::Create(createInfos);
+            g_mat = materials[0];
+            g_chunkMaterial = materials[1];
+            blockIndicatorMaterial = materials[2];
+
+            m_materialCreationTime = duration<f32, milliseconds::period>(high_resolution_clock::now() - start).count();
+            std::cout << std::format("Created {} materials in {:.1f} ms, pipeline cache {}\n", materials.size(), m_materialCreationTime,
+                                     RendererAPI::GetState().pipelineCacheLoaded ? "loaded" : "empty");
+        }
 
         m_world = CreateScope<World>();
-        m_player = CreateScope<Player>(*m_world);
+        m_player = CreateScope<Player>(*m_world, blockIndicatorMaterial);
 
         m_window->LockCursor();
         
         g_texture = RendererAPI::LoadTexture("assets/texture.png");
-        auto des = Vertex3D::GetDescription();
-        g_mat = Material::Create("default", des);
         g_mat->SetTexture(g_texture);
         
         g_atlas = RendererAPI::LoadTexture("assets/atlas.png", VK_FILTER_NEAREST);
-        g_chunkMaterial = Material::Create("chunk", des);
         g_chunkMaterial->SetTexture(g_atlas);
         
         // Game
@@ -95,6 +131,9 @@ namespace mc
         g_chunkMaterial = nullptr;
         RendererAPI::DeleteTexture(g_atlas);
 
+        // Workers may still be generating chunks of the world
+        JobSystem::Deinit();
+        
         m_player.reset(nullptr);
         m_world.reset(nullptr);
 
@@ -110,6 +149,8 @@ namespace mc
     }
 
     void Application::Update() {
+        MC_PROFILE_SCOPE("Application::Update");
+
         {
             using namespace std::chrono;
             auto now = high_resolution_clock::now();
@@ -119,7 +160,10 @@ namespace mc
             // printf("%d\n", (i32)(1.f / (m_deltaTime)));
         }
 
-        m_window->Update();
+        {
+            MC_PROFILE_SCOPE("Window::Update");
+            m_window->Update();
+        }
 
         if(m_isFocused) {
             if(Input::GetKey(KeyCode::Escape).down) {
@@ -134,8 +178,10 @@ namespace mc
             }
         }
 
-        if(m_isFocused)
+        if(m_isFocused) {
+            MC_PROFILE_SCOPE("Player::Update");
             m_player->Update(m_deltaTime);
+        }
 
         ChunkManager::Update(*m_world);
 
@@ -146,8 +192,9 @@ namespace mc
     }
     
     void Application::Render() const {
+        MC_PROFILE_SCOPE("Application::Render");
         g_chunkMaterial->Bind();
-        m_world->Render();
+        m_world->Render(m_player->GetCamera());
         m_player->Render();
 
         g_mat->Bind();
@@ -160,7 +207,104 @@ namespace mc
     }
 
     void Application::RenderGUI() {
+        MC_PROFILE_SCOPE("Application::RenderGUI");
         ImGui::ShowDemoWindow();
+        Profiler::RenderGUI();
+
+        if(ImGui::Begin("Debug")) {
+            i32 meshingMode = (i32)ChunkMesher::GetMode();
+            if(ImGui::Combo("Meshing", &meshingMode, "Naive\0Greedy\0")) {
+                ChunkMesher::SetMode((ChunkMesher::Mode)meshingMode);
+                m_world->UpdateMesh();
+            }
+
+            bool frustumCulling = m_world->IsFrustumCulling();
+            if(ImGui::Checkbox("Frustum culling", &frustumCulling))
+                m_world->SetFrustumCulling(frustumCulling);
+            
+            ImGui::SameLine();
+            bool simdCulling = m_world->IsSimdCulling();
+            if(ImGui::Checkbox("SIMD", &simdCulling))
+                m_world->SetSimdCulling(simdCulling);
+
+            ImGui::SameLine();
+            bool caveCulling = m_world->IsCaveCulling();
+            if(ImGui::Checkbox("Cave culling", &caveCulling))
+                m_world->SetCaveCulling(caveCulling);
+
+            ImGui::SameLine();
+            bool hiZCulling = m_world->IsHiZCulling();
+            if(ImGui::Checkbox("Hi-Z culling", &hiZCulling))
+                m_world->SetHiZCulling(hiZCulling);
+
+            ImGui::SameLine();
+            bool backfaceCulling = m_world->IsBackfaceCulling();
+            if(ImGui::Checkbox("Backface culling", &backfaceCulling))
+                m_world->SetBackfaceCulling(backfaceCulling);
+
+            ImGui::SameLine();
+            bool indirectDrawing = m_world->IsIndirectDrawing();
+            if(ImGui::Checkbox("Indirect", &indirectDrawing))
+                m_world->SetIndirectDrawing(indirectDrawing);
+            if(!RendererAPI::SupportsIndirectDraw()) {
+                ImGui::SameLine();
+                ImGui::TextUnformatted("(unsupported)");
+            }
+
+            ImGui::SameLine();
+            bool parallelRecording = m_world->IsParallelRecording();
+            if(ImGui::Checkbox("Parallel recording", &parallelRecording))
+                m_world->SetParallelRecording(parallelRecording);
+
+            ImGui::SameLine();
+            if(ImGui::Button("Dump hi-Z"))
+                for(u32 level = 0; level < OcclusionBuffer::LEVEL_COUNT; level++)
+                    m_world->GetOcclusionBuffer().WriteImage(std::format("hiz_level{}.pgm", level), level);
+
+            const RenderStats& renderStats = m_world->GetRenderStats();
+            ImGui::Text("Chunks: %u drawn of %u (cull %.1f us)", renderStats.drawnCount, renderStats.chunkCount, renderStats.cullMicroseconds);
+            ImGui::Text("Culled: %u frustum, %u cave, %u hi-Z (%u occluders)", renderStats.frustumCulledCount, renderStats.occlusionCulledCount,
+                        renderStats.hiZCulledCount, renderStats.occluderCount);
+            u32 submittedQuads = renderStats.drawnQuadCount + renderStats.backfaceCulledQuadCount;
+            ImGui::Text("Quads: %u drawn, %u back facing skipped (%.1f%%)", renderStats.drawnQuadCount, renderStats.backfaceCulledQuadCount,
+                        submittedQuads == 0 ? 0.f : 100.f * (f32)renderStats.backfaceCulledQuadCount / (f32)submittedQuads);
+            ImGui::Text("Draws: %u indirect (%u slices), %u direct (%u command buffers), record %.1f us", renderStats.indirectDrawCount,
+                        renderStats.indirectSliceCount, renderStats.directDrawCount, renderStats.recordSliceCount, renderStats.recordMicroseconds);
+
+            u64 vertexCount = 0;
+            for(const ChunkColumn& column : m_world->GetChunkColumns())
+                for(const Scope<Chunk>& chunk : column.GetChunks())
+                    if(chunk)
+                        vertexCount += chunk->GetQuadCount() * 4ull;
+
+            u64 meshMemory = vertexCount * sizeof(ChunkVertex);
+            ImGui::Text("Chunk meshes: %llu quads, %llu vertices, %.2f MiB", vertexCount / 4, vertexCount, (f64)meshMemory / (1024.0 * 1024.0));
+
+            MemoryStats memoryStats = MemoryAllocator::GetStats();
+            ImGui::Text("GPU memory: %.2f / %.2f MiB in %llu blocks + %llu dedicated, %llu allocations",
+                        (f64)memoryStats.usedBytes / (1024.0 * 1024.0), (f64)memoryStats.reservedBytes / (1024.0 * 1024.0),
+                        memoryStats.blockCount, memoryStats.dedicatedCount, memoryStats.allocationCount);
+            ImGui::Text("GPU memory fragmentation: %.1f%% (%llu free ranges)", memoryStats.GetFragmentation() * 100.f, memoryStats.freeRangeCount);
+            ImGui::Text("Staging ring: %.2f / %.2f MiB, %llu overflows", (f64)StagingRing::GetUsedBytes() / (1024.0 * 1024.0),
+                        (f64)StagingRing::GetCapacity() / (1024.0 * 1024.0), StagingRing::GetOverflowCount());
+            ImGui::Text("Geometry arena: %.2f / %.2f MiB, fragmentation %.1f%%, %llu fallbacks",
+                        (f64)(GeometryArena::GetUsedQuads() * 4 * sizeof(ChunkVertex)) / (1024.0 * 1024.0),
+                        (f64)(GeometryArena::GetCapacity() * 4 * sizeof(ChunkVertex)) / (1024.0 * 1024.0),
+                        GeometryArena::GetFragmentation() * 100.f, GeometryArena::GetFailedCount());
+            ImGui::Text("Uploads last frame: %u copies, %.2f KiB", RendererAPI::GetLastUploadCount(), (f64)RendererAPI::GetLastUploadBytes() / 1024.0);
+            GpuFrameTiming gpuTiming = RendererAPI::GetLastGpuFrameTiming();
+            if(gpuTiming.milliseconds >= 0)
+                ImGui::Text("GPU frame: %.3f ms", gpuTiming.milliseconds);
+            else
+                ImGui::TextUnformatted("GPU frame: timestamps unsupported");
+            DeletionStats deletionStats = DeletionQueue::GetStats();
+            ImGui::Text("Pending deletions: %llu buffers (%.2f MiB), %llu images, %llu arena ranges, %llu deleted in total",
+                        deletionStats.bufferCount, (f64)deletionStats.bufferBytes / (1024.0 * 1024.0),
+                        deletionStats.imageCount, deletionStats.geometryRangeCount, DeletionQueue::GetDeletedCount());
+            ImGui::Text("Startup: first frame after %.1f ms, materials %.1f ms (pipeline cache %s)", m_timeToFirstFrame, m_materialCreationTime,
+                        RendererAPI::GetState().pipelineCacheLoaded ? "loaded" : "empty");
+        }
+        ImGui::End();
     }
 
     void Application::OnEvent(WindowCloseEvent& ev) {
@@ -48,6 +48,11 @@ namespace mc
 
         float m_deltaTime{};
         std::chrono::high_resolution_clock::time_point m_lastFrameTimePoint = std::chrono::high_resolution_clock::now();
+
+        // Startup timings in milliseconds, measured from construction until the first frame is submitted
+        std::chrono::high_resolution_clock::time_point m_startTimePoint = std::chrono::high_resolution_clock::now();
+        f32 m_timeToFirstFrame = 0;
+        f32 m_materialCreationTime = 0;
         
         Scope<Window> m_window;
 
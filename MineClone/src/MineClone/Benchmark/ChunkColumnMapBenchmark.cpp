@@ -0,0 +1,90 @@
+﻿#include "mcpch.h"
+#include "ChunkColumnMapBenchmark.h"
+
+#include <random>
+
+#include "MineClone/Game/World/World.h"
+
+namespace mc
+{
+    static constexpr u64 RANDOM_LOOKUPS = 1ull << 22;
+
+    template<typename Lookup>
+    static void Measure(std::string_view name, u64 lookups, Lookup&& lookup) {
+        using namespace std::chrono;
+        auto start = high_resolution_clock::now();
+
+        u64 found = lookup();
+
+        f64 ns = (f64)duration_cast<nanoseconds>(high_resolution_clock::now() - start).count();
+        std::cout << std::format("  {:<36} {:>8.2f} ns/lookup ({} hits)\n", name, ns / (f64)lookups, found);
+    }
+
+    void ChunkColumnMapBenchmark::Run() {
+        Run(Config::DELETE_DISTANCE);
+        Run(32);
+    }
+
+    void ChunkColumnMapBenchmark::Run(i32 radius) {
+        World world;
+
+        ChunkColumnMap columnMap;
+        std::unordered_map<int2, ChunkColumn> unorderedMap;
+
+        for(i32 x = -radius; x <= radius; x++)
+            for(i32 z = -radius; z <= radius; z++) {
+                columnMap.Emplace({x, z}, world);
+                unorderedMap.emplace(std::piecewise_construct, std::forward_as_tuple(x, z), std::forward_as_tuple(int2{x, z}, world));
+            }
+
+        std::cout << std::format("Chunk column map benchmark, {} columns:\n", columnMap.GetSize());
+
+        // Random lookups over a slightly larger area so some of them miss, like lookups across the loaded border
+        std::mt19937 random(1337);
+        std::uniform_int_distribution<i32> distribution(-radius - 2, radius + 2);
+        std::vector<int2> randomIDs(RANDOM_LOOKUPS);
+        for(int2& id : randomIDs)
+            id = {distribution(random), distribution(random)};
+
+        Measure("random, unordered_map contains+at", RANDOM_LOOKUPS, [&] {
+            u64 found = 0;
+            for(int2 id : randomIDs)
+                if(unorderedMap.contains(id))
+                    found += unorderedMap.at(id).GetID().x != INT32_MIN;
+            return found;
+        });
+
+        Measure("random, ChunkColumnMap::Find", RANDOM_LOOKUPS, [&] {
+            u64 found = 0;
+            for(int2 id : randomIDs)
+                if(const ChunkColumn* column = columnMap.Find(id))
+                    found += column->GetID().x != INT32_MIN;
+            return found;
+        });
+
+        // Sequential block order scan, one column lookup per block like World::GetBlockState during meshing
+        u64 sequentialLookups = (u64)(2 * radius + 1) * (2 * radius + 1) * Config::CHUNK_SIZE.x * Config::CHUNK_SIZE.z;
+        i32 minBlock = -radius * Config::CHUNK_SIZE.x;
+        i32 maxBlock = (radius + 1) * Config::CHUNK_SIZE.x;
+
+        Measure("sequential, unordered_map contains+at", sequentialLookups, [&] {
+            u64 found = 0;
+            for(i32 x = minBlock; x < maxBlock; x++)
+                for(i32 z = minBlock; z < maxBlock; z++) {
+                    int2 id = IBlockStateProvider::ToChunkID(int3{x, 0, z}).xz;
+                    if(unorderedMap.contains(id))
+                        found += unorderedMap.at(id).GetID().x != INT32_MIN;
+                }
+            return found;
+        });
+
+        Measure("sequential, ChunkColumnMap::Find", sequentialLookups, [&] {
+            u64 found = 0;
+            for(i32 x = minBlock; x < maxBlock; x++)
+                for(i32 z = minBlock; z < maxBlock; z++)
+                    if(const ChunkColumn* column = columnMap.Find(IBlockStateProvider::ToChunkID(int3{x, 0, z}).xz))
+                        found += column->GetID().x != INT32_MIN;
+            return found;
+        });
+    }
+}
@@ -0,0 +1,15 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Compares ChunkColumnMap against the node based std::unordered_map it replaced.
+    // Run with --bench-column-map.
+    class ChunkColumnMapBenchmark
+    {
+    public:
+        static void Run();
+
+    private:
+        static void Run(i32 radius);
+    };
+}
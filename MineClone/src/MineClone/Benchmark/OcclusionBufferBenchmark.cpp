@@ -0,0 +1,94 @@
+﻿#include "mcpch.h"
+#include "OcclusionBufferBenchmark.h"
+
+#include <cstring>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "MineClone/Core/Renderer/OcclusionBuffer.h"
+#include "MineClone/Core/Threading/JobSystem.h"
+
+namespace mc
+{
+    static constexpr i32 TERRAIN_RADIUS = 64;
+    static constexpr i32 TILE_SIZE = 4;
+    static constexpr u32 ITERATIONS = 100;
+
+    static i32 GetTerrainHeight(i32 x, i32 z) {
+        return 64 + (i32)(24.f * std::sin((f32)x * 0.05f) * std::cos((f32)z * 0.04f) + 8.f * std::sin((f32)(x + z) * 0.13f));
+    }
+
+    static void AddTerrain(OcclusionBuffer& buffer) {
+        for(i32 x = -TERRAIN_RADIUS; x < TERRAIN_RADIUS; x += TILE_SIZE)
+            for(i32 z = -TERRAIN_RADIUS; z < TERRAIN_RADIUS; z += TILE_SIZE)
+                buffer.AddOccluder(float3(x, 0, z), float3(x + TILE_SIZE, GetTerrainHeight(x, z), z + TILE_SIZE));
+    }
+
+    template<typename Function>
+    static f64 MeasureMicroseconds(Function&& function) {
+        using namespace std::chrono;
+        auto start = high_resolution_clock::now();
+
+        for(u32 i = 0; i < ITERATIONS; i++)
+            function();
+
+        return duration<f64, std::micro>(high_resolution_clock::now() - start).count() / ITERATIONS;
+    }
+
+    void OcclusionBufferBenchmark::Run() {
+        JobSystem::Init();
+
+        // Low above the hills looking across them, like a player standing on a hilltop
+        Mat4 projection = glm::perspective(glm::radians(70.f), (f32)OcclusionBuffer::WIDTH / (f32)OcclusionBuffer::HEIGHT, 0.1f, 1000.f);
+        Mat4 view = glm::lookAt(float3(-TERRAIN_RADIUS, 96, -TERRAIN_RADIUS), float3(0, 64, 0), float3(0, 1, 0));
+        Mat4 viewProjection = projection * view;
+
+        OcclusionBuffer single;
+        OcclusionBuffer parallel;
+
+        f64 singleMicroseconds = MeasureMicroseconds([&] {
+            single.Begin(viewProjection);
+            AddTerrain(single);
+            single.Rasterize(false);
+        });
+
+        f64 parallelMicroseconds = MeasureMicroseconds([&] {
+            parallel.Begin(viewProjection);
+            AddTerrain(parallel);
+            parallel.Rasterize(true);
+        });
+
+        bool identical = true;
+        for(u32 level = 0; level < OcclusionBuffer::LEVEL_COUNT; level++) {
+            std::span<const f32> a = single.GetLevel(level);
+            std::span<const f32> b = parallel.GetLevel(level);
+            identical &= std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+        }
+
+        // Chunk sized boxes below and behind the hills, as World::Render would test them
+        u32 testedCount = 0;
+        u32 occludedCount = 0;
+        for(i32 x = -TERRAIN_RADIUS * 4; x < TERRAIN_RADIUS * 4; x += 16)
+            for(i32 y = 0; y < 128; y += 16)
+                for(i32 z = -TERRAIN_RADIUS * 4; z < TERRAIN_RADIUS * 4; z += 16) {
+                    testedCount++;
+                    occludedCount += !parallel.IsVisible(float3(x, y, z), float3(x + 16, y + 16, z + 16));
+                }
+
+        std::cout << std::format("Occlusion buffer benchmark, {}x{}, {} occluders, {} workers:\n",
+                                 OcclusionBuffer::WIDTH, OcclusionBuffer::HEIGHT, parallel.GetOccluderCount(), JobSystem::GetWorkerCount());
+        std::cout << std::format("  single threaded   {:>8.1f} us/frame\n", singleMicroseconds);
+        std::cout << std::format("  parallel          {:>8.1f} us/frame\n", parallelMicroseconds);
+        std::cout << std::format("  deterministic     {}\n", identical ? "yes" : "NO, buffers differ");
+        std::cout << std::format("  occluded          {} of {} chunk boxes\n", occludedCount, testedCount);
+
+        for(u32 level = 0; level < OcclusionBuffer::LEVEL_COUNT; level++)
+            parallel.WriteImage(std::format("hiz_level{}.pgm", level), level);
+        std::cout << std::format("  wrote hiz_level0.pgm .. hiz_level{}.pgm\n", OcclusionBuffer::LEVEL_COUNT - 1);
+
+        JobSystem::Deinit();
+
+        if(!identical)
+            throw std::runtime_error("occlusion buffer is not deterministic across thread counts!");
+    }
+}
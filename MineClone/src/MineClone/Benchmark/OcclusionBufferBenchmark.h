@@ -0,0 +1,13 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Rasterizes a synthetic hilly heightfield into OcclusionBuffer single threaded and on the JobSystem,
+    // checks both depth buffers are bit identical and dumps the pyramid as PGM images.
+    // Run with --bench-hiz, needs no window or GPU.
+    class OcclusionBufferBenchmark
+    {
+    public:
+        static void Run();
+    };
+}
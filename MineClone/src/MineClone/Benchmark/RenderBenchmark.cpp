@@ -0,0 +1,282 @@
+﻿#include "mcpch.h"
+#include "RenderBenchmark.h"
+
+#include <charconv>
+#include <optional>
+#include <sstream>
+
+#include "MineClone/Core/Renderer/RendererAPI.h"
+#include "MineClone/Core/Renderer/RendererTypes.h"
+#include "MineClone/Core/Renderer/VulkanTypes.h"
+#include "MineClone/Core/Threading/JobSystem.h"
+#include "MineClone/Game/World/Chunk.h"
+#include "MineClone/Game/World/ChunkManager.h"
+#include "MineClone/Game/World/Generator/ChunkGenerator.h"
+#include "MineClone/Game/World/World.h"
+
+namespace mc
+{
+    static std::optional<std::string_view> GetOption(std::span<const std::string_view> args, std::string_view name) {
+        auto it = std::ranges::find(args, name);
+        if(it == args.end() || it + 1 == args.end())
+            return std::nullopt;
+        return *(it + 1);
+    }
+
+    template<typename T>
+    static T ParseNumber(std::string_view text, std::string_view option) {
+        T value{};
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(error != std::errc{} || end != text.data() + text.size())
+            throw std::runtime_error(std::format("invalid value {} for {}!", text, option));
+        return value;
+    }
+
+    template<typename Function>
+    static f32 MeasureMilliseconds(Function&& function) {
+        using namespace std::chrono;
+        auto start = high_resolution_clock::now();
+        function();
+        return duration<f32, milliseconds::period>(high_resolution_clock::now() - start).count();
+    }
+
+    void RenderBenchmark::Run(std::span<const std::string_view> args) {
+        u32 frameCount = 600;
+        uint2 size = {1280, 720};
+        u32 captureInterval = 60;
+        std::filesystem::path captureDirectory;
+        std::vector<Keyframe> path = GetDefaultPath();
+        std::ofstream csvFile;
+
+        if(auto frames = GetOption(args, "--frames"))
+            frameCount = std::max(ParseNumber<u32>(*frames, "--frames"), 1u);
+        if(auto sizeOption = GetOption(args, "--size")) {
+            u64 separator = sizeOption->find('x');
+            if(separator == std::string_view::npos)
+                throw std::runtime_error("--size takes WIDTHxHEIGHT!");
+            size = {ParseNumber<u32>(sizeOption->substr(0, separator), "--size"), ParseNumber<u32>(sizeOption->substr(separator + 1), "--size")};
+        }
+        if(auto pathOption = GetOption(args, "--path"))
+            path = LoadPath(*pathOption);
+        if(auto capture = GetOption(args, "--capture")) {
+            captureDirectory = *capture;
+            std::filesystem::create_directories(captureDirectory);
+        }
+        if(auto interval = GetOption(args, "--capture-every"))
+            captureInterval = std::max(ParseNumber<u32>(*interval, "--capture-every"), 1u);
+        if(auto csv = GetOption(args, "--csv")) {
+            csvFile.open(std::filesystem::path(*csv));
+            if(!csvFile)
+                throw std::runtime_error(std::format("failed to open {} for writing!", *csv));
+        }
+        std::ostream& csv = csvFile.is_open() ? csvFile : std::cout;
+
+        RendererAPI::InitHeadless(size.x, size.y);
+        JobSystem::Init();
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(RendererAPI::GetState().physicalDevice, &properties);
+
+        Ref<Material> chunkMaterial = Material::Create("chunk", ChunkVertex::GetDescription());
+        Ref<Texture> atlas = RendererAPI::LoadTexture("assets/atlas.png", VK_FILTER_NEAREST);
+        chunkMaterial->SetTexture(atlas);
+
+        ChunkGenerator::Init(2137);
+
+        Scope<World> world = CreateScope<World>();
+        Camera camera(60.f, size.x, size.y);
+
+        int3 currentChunkID{std::numeric_limits<i32>::max()};
+        u64 submittedFrames = 0;
+
+        auto moveCamera = [&](const Keyframe& keyframe) {
+            camera.SetPosition(keyframe.position);
+            camera.SetRotation(keyframe.rotation);
+
+            int3 chunkID = Chunk::ToChunkID(glm::floor(keyframe.position));
+            if(chunkID != currentChunkID) {
+                ChunkManager::UpdatePlayer(*world, chunkID);
+                currentChunkID = chunkID;
+            }
+        };
+
+        auto renderFrame = [&] {
+            RendererAPI::BeginFrame(DELTA_TIME, camera);
+            chunkMaterial->Bind();
+            world->Render(camera);
+            RendererAPI::EndFrame();
+            submittedFrames++;
+        };
+
+        // Generate and mesh everything around the start first, uploads are recorded by the frames after that
+        using namespace std::chrono;
+        auto warmupStart = high_resolution_clock::now();
+
+        moveCamera(SamplePath(path, 0));
+        u32 idleFrames = 0;
+        for(u32 i = 0; i < MAX_WARMUP_FRAMES && idleFrames <= FrameData::MAX_FRAMES_IN_FLIGHT; i++) {
+            ChunkManager::Update(*world);
+            renderFrame();
+            idleFrames = ChunkManager::IsIdle() ? idleFrames + 1 : 0;
+        }
+
+        std::cout << std::format("Render benchmark on {}, {}x{}, {} frames, {} keyframes, {} workers. Warm up took {} frames, {:.1f} ms\n",
+                                 properties.deviceName, size.x, size.y, frameCount, path.size(), JobSystem::GetWorkerCount(), submittedFrames,
+                                 duration<f32, milliseconds::period>(high_resolution_clock::now() - warmupStart).count());
+
+        // GPU times arrive MAX_FRAMES_IN_FLIGHT frames late, filled in from GetLastGpuFrameTiming as they complete
+        u64 firstFrameIndex = submittedFrames;
+        std::vector<FrameTiming> timings(frameCount);
+
+        auto collectGpuTiming = [&] {
+            GpuFrameTiming gpuTiming = RendererAPI::GetLastGpuFrameTiming();
+            if(gpuTiming.milliseconds < 0 || gpuTiming.frameIndex < firstFrameIndex || gpuTiming.frameIndex - firstFrameIndex >= frameCount)
+                return;
+
+            FrameTiming& timing = timings[gpuTiming.frameIndex - firstFrameIndex];
+            timing.gpuMilliseconds = gpuTiming.milliseconds;
+            timing.gpuRenderPassMilliseconds = gpuTiming.renderPassMilliseconds;
+        };
+
+        for(u32 frame = 0; frame < frameCount; frame++) {
+            FrameTiming& timing = timings[frame];
+
+            timing.frameMilliseconds = MeasureMilliseconds([&] {
+                timing.updateMilliseconds = MeasureMilliseconds([&] {
+                    moveCamera(SamplePath(path, frameCount == 1 ? 0.f : (f32)frame / (f32)(frameCount - 1)));
+                    ChunkManager::Update(*world);
+                });
+
+                // Includes waiting for the frame in flight before, which is where a GPU bound run spends its time
+                RendererAPI::BeginFrame(DELTA_TIME, camera);
+                collectGpuTiming();
+
+                timing.recordMilliseconds = MeasureMilliseconds([&] {
+                    chunkMaterial->Bind();
+                    world->Render(camera);
+
+                    if(!captureDirectory.empty() && frame % captureInterval == 0)
+                        RendererAPI::CaptureFrame(captureDirectory / std::format("frame_{:05}.png", frame));
+
+                    RendererAPI::EndFrame();
+                });
+                submittedFrames++;
+            });
+
+            const RenderStats& renderStats = world->GetRenderStats();
+            timing.drawnChunkCount = renderStats.drawnCount;
+            timing.drawnQuadCount = renderStats.drawnQuadCount;
+        }
+
+        // Empty frames, only there to read back the timestamps of the last measured ones
+        for(u32 i = 0; i < FrameData::MAX_FRAMES_IN_FLIGHT; i++) {
+            RendererAPI::BeginFrame(DELTA_TIME, camera);
+            collectGpuTiming();
+            RendererAPI::EndFrame();
+        }
+
+        csv << "frame,frame_ms,update_ms,record_ms,gpu_ms,gpu_pass_ms,drawn_chunks,drawn_quads\n";
+        for(u32 frame = 0; frame < frameCount; frame++) {
+            const FrameTiming& timing = timings[frame];
+            csv << std::format("{},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{},{}\n", frame, timing.frameMilliseconds, timing.updateMilliseconds,
+                               timing.recordMilliseconds, timing.gpuMilliseconds, timing.gpuRenderPassMilliseconds, timing.drawnChunkCount,
+                               timing.drawnQuadCount);
+        }
+
+        auto select = [&](f32 FrameTiming::* member) {
+            std::vector<f32> values;
+            for(const FrameTiming& timing : timings)
+                if(timing.*member >= 0)
+                    values.push_back(timing.*member);
+            return values;
+        };
+
+        PrintSummary("frame", select(&FrameTiming::frameMilliseconds));
+        PrintSummary("update", select(&FrameTiming::updateMilliseconds));
+        PrintSummary("record", select(&FrameTiming::recordMilliseconds));
+        PrintSummary("gpu", select(&FrameTiming::gpuMilliseconds));
+        PrintSummary("gpu pass", select(&FrameTiming::gpuRenderPassMilliseconds));
+
+        RendererAPI::Wait();
+        chunkMaterial = nullptr;
+        RendererAPI::DeleteTexture(atlas);
+
+        // Workers may still be generating chunks of the world
+        JobSystem::Deinit();
+        world.reset();
+
+        RendererAPI::Deinit();
+    }
+
+    std::vector<RenderBenchmark::Keyframe> RenderBenchmark::LoadPath(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        if(!file)
+            throw std::runtime_error(std::format("failed to open camera path {}!", path.string()));
+
+        std::vector<Keyframe> keyframes;
+        std::string line;
+        while(std::getline(file, line)) {
+            if(line.empty() || line.front() == '#')
+                continue;
+
+            Keyframe keyframe;
+            std::istringstream stream(line);
+            if(!(stream >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z >> keyframe.rotation.x >> keyframe.rotation.y))
+                throw std::runtime_error(std::format("invalid camera keyframe \"{}\" in {}!", line, path.string()));
+
+            keyframes.push_back(keyframe);
+        }
+
+        if(keyframes.empty())
+            throw std::runtime_error(std::format("camera path {} has no keyframes!", path.string()));
+
+        return keyframes;
+    }
+
+    std::vector<RenderBenchmark::Keyframe> RenderBenchmark::GetDefaultPath() {
+        constexpr u32 ORBIT_STEPS = 32;
+        constexpr f32 ORBIT_RADIUS = 40.f;
+
+        // One circle around spawn looking at it, then straight out over unloaded terrain so chunks stream in
+        std::vector<Keyframe> keyframes;
+        for(u32 i = 0; i <= ORBIT_STEPS; i++) {
+            f32 angle = 360.f * (f32)i / (f32)ORBIT_STEPS;
+            f32 radians = glm::radians(angle);
+            keyframes.push_back({{ORBIT_RADIUS * std::sin(radians), 100.f, ORBIT_RADIUS * std::cos(radians)}, {-30.f, angle}});
+        }
+
+        keyframes.push_back({{ORBIT_RADIUS * 4, 110.f, ORBIT_RADIUS}, {-20.f, 270.f}});
+        return keyframes;
+    }
+
+    RenderBenchmark::Keyframe RenderBenchmark::SamplePath(std::span<const Keyframe> path, f32 t) {
+        if(path.size() == 1)
+            return path.front();
+
+        f32 position = std::clamp(t, 0.f, 1.f) * (f32)(path.size() - 1);
+        u64 index = std::min((u64)position, path.size() - 2);
+        f32 blend = position - (f32)index;
+
+        return {
+            glm::mix(path[index].position, path[index + 1].position, blend),
+            glm::mix(path[index].rotation, path[index + 1].rotation, blend),
+        };
+    }
+
+    void RenderBenchmark::PrintSummary(std::string_view name, std::vector<f32> milliseconds) {
+        if(milliseconds.empty()) {
+            std::cout << std::format("  {:<8} n/a\n", name);
+            return;
+        }
+
+        std::ranges::sort(milliseconds);
+        auto percentile = [&](f32 p) { return milliseconds[std::min((u64)(p * (f32)milliseconds.size()), milliseconds.size() - 1)]; };
+
+        f64 sum = 0;
+        for(f32 value : milliseconds)
+            sum += value;
+
+        std::cout << std::format("  {:<8} avg {:>8.3f} ms, p50 {:>8.3f}, p95 {:>8.3f}, p99 {:>8.3f}, max {:>8.3f}\n", name,
+                                 sum / (f64)milliseconds.size(), percentile(0.5f), percentile(0.95f), percentile(0.99f), milliseconds.back());
+    }
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Flies a camera along a scripted path through a generated world without a window, printing CPU and GPU time
+    // of every frame as CSV followed by percentiles. Run with --bench-render, options:
+    //   --frames N         measured frames, default 600
+    //   --size WxH         offscreen target size, default 1280x720
+    //   --path FILE        keyframes as "x y z pitch yaw" lines, default orbits spawn and flies off
+    //   --capture DIR      writes every --capture-every frame (default 60) to DIR as PNG, the file is written
+    //                      during the frame two later, which then measures slower
+    //   --csv FILE         per frame CSV goes to FILE instead of stdout
+    // Use VK_ICD_FILENAMES to pick a software implementation such as lavapipe on machines without a GPU.
+    class RenderBenchmark
+    {
+    public:
+        static void Run(std::span<const std::string_view> args);
+
+    private:
+        struct Keyframe
+        {
+            float3 position;
+            // Pitch and yaw in degrees, as Camera::SetRotation takes them
+            float2 rotation;
+        };
+
+        struct FrameTiming
+        {
+            f32 frameMilliseconds = 0;
+            f32 updateMilliseconds = 0;
+            f32 recordMilliseconds = 0;
+            f32 gpuMilliseconds = -1.f;
+            f32 gpuRenderPassMilliseconds = -1.f;
+            u32 drawnChunkCount = 0;
+            u32 drawnQuadCount = 0;
+        };
+
+        static std::vector<Keyframe> LoadPath(const std::filesystem::path& path);
+        static std::vector<Keyframe> GetDefaultPath();
+        // t runs from 0 at the first keyframe to 1 at the last one, keyframes are spaced evenly in time
+        static Keyframe SamplePath(std::span<const Keyframe> path, f32 t);
+
+        static void PrintSummary(std::string_view name, std::vector<f32> milliseconds);
+
+    private:
+        // Frames rendered before the world counts as loaded, the benchmark starts either way afterwards
+        static constexpr u32 MAX_WARMUP_FRAMES = 10000;
+        static constexpr f32 DELTA_TIME = 1.f / 60.f;
+    };
+}
@@ -67,6 +67,37 @@ namespace mc
         };
     }
 
+    ChunkVertex ChunkVertex::Pack(int3 pos, u32 face, u32 corner, u32 tile, u32 ao, u32 light) {
+        return {
+            .data = (u32)pos.x       |
+                    (u32)pos.y << 5  |
+                    (u32)pos.z << 10 |
+                    face       << 15 |
+                    corner     << 18 |
+                    ao         << 20 |
+                    light      << 22,
+            .tile = tile,
+        };
+    }
+
+    VertexDescription ChunkVertex::GetDescription() {
+        return {
+            .bindingDescription = {
+                .binding = 0,
+                .stride = sizeof(ChunkVertex),
+                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+            },
+            .attributeDescriptions = {
+                {
+                    .location = 0,
+                    .binding = 0,
+                    .format = VK_FORMAT_R32G32_UINT,
+                    .offset = 0,
+                },
+            },
+        };
+    }
+
 
     const std::array<u32, 6ull * 6ull> Config::INDICES = {{
         // Top
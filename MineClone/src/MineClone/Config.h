@@ -19,6 +19,14 @@ namespace mc
         static constexpr i32 SEA_LEVEL = 64;
 
         static constexpr u64 RENDER_DISTANCE = 5;
+        static constexpr i32 DELETE_DISTANCE = (i32)(RENDER_DISTANCE * 1.25f);
+
+        // Size of the persistently mapped ring all GPU uploads are staged through
+        static constexpr u64 STAGING_BUFFER_SIZE_MB = 32;
+        // Device local buffer all chunk meshes are placed in, see GeometryArena
+        static constexpr u64 GEOMETRY_ARENA_SIZE_MB = 64;
+        // VkPipelineCache contents kept between runs, relative to the working directory
+        static constexpr std::string_view PIPELINE_CACHE_PATH = "pipeline_cache.bin";
 
         static constexpr ulong2 TEXTURE_SIZE = {16, 16};
         
@@ -55,4 +63,22 @@ namespace mc
 
         static VertexDescription GetDescription();
     };
+
+    // Packed 8 byte chunk mesh vertex, unpacked in chunk.vert.
+    // data holds x, y, z (5 bits each, 0-16), face (3), corner (2), ambient occlusion (2) and light (4) from the lowest bit up,
+    // tile is the atlas tile index. Normals and repeating texture coordinates are derived from face and position.
+    struct ChunkVertex
+    {
+        u32 data;
+        u32 tile;
+
+        static constexpr u32 MAX_AO = 3;
+        static constexpr u32 MAX_LIGHT = 15;
+
+        static ChunkVertex Pack(int3 pos, u32 face, u32 corner, u32 tile, u32 ao = MAX_AO, u32 light = MAX_LIGHT);
+
+        u32 GetFace() const { return data >> 15 & 7; }
+
+        static VertexDescription GetDescription();
+    };
 }
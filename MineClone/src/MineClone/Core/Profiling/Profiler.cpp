@@ -0,0 +1,186 @@
+﻿#include "mcpch.h"
+#include "Profiler.h"
+
+#include "imgui.h"
+
+#include "MineClone/Core/Renderer/RendererAPI.h"
+
+namespace mc
+{
+    static thread_local u32 t_threadIndex = ~0u;
+    static thread_local u32 t_depth = 0;
+
+    static f32 ToMilliseconds(std::chrono::high_resolution_clock::duration duration) {
+        return std::chrono::duration<f32, std::milli>(duration).count();
+    }
+
+    // Stable color per scope name, so a scope keeps its color from frame to frame
+    static ImU32 GetEventColor(std::string_view name) {
+        f32 hue = (f32)(std::hash<std::string_view>{}(name) % 360) / 360.f;
+        return ImColor::HSV(hue, 0.55f, 0.7f);
+    }
+
+    void FrameHistory::Push(f32 milliseconds) {
+        m_samples[m_next] = milliseconds;
+        m_next = (m_next + 1) % SIZE;
+        m_count = std::min(m_count + 1, SIZE);
+    }
+
+    FramePercentiles FrameHistory::GetPercentiles() const {
+        if(m_count == 0)
+            return {};
+
+        std::array<f32, SIZE> sorted;
+        std::ranges::copy(GetSamples(), sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + m_count);
+
+        auto percentile = [&](f32 p) { return sorted[std::min((u32)(p * (f32)m_count), m_count - 1)]; };
+        return {percentile(0.5f), percentile(0.95f), percentile(0.99f)};
+    }
+
+    void Profiler::BeginFrame() {
+        auto now = std::chrono::high_resolution_clock::now();
+        s_mainThreadIndex = GetThreadIndex();
+
+        {
+            std::lock_guard lock(s_mutex);
+            f32 frameMilliseconds = ToMilliseconds(now - s_frameStart);
+
+            // The first frame would also measure everything since startup
+            if(s_frameCount++ > 0)
+                s_cpuFrameHistory.Push(frameMilliseconds);
+
+            if(!s_paused) {
+                std::swap(s_lastEvents, s_events);
+                s_lastFrameMilliseconds = frameMilliseconds;
+                s_lastDroppedCount = s_droppedCount;
+            }
+
+            s_events.clear();
+            s_droppedCount = 0;
+            s_frameStart = now;
+        }
+
+        GpuFrameTiming gpuTiming = RendererAPI::GetLastGpuFrameTiming();
+        if(gpuTiming.milliseconds >= 0 && gpuTiming.frameIndex != s_lastGpuFrameIndex) {
+            s_lastGpuFrameIndex = gpuTiming.frameIndex;
+            s_gpuFrameHistory.Push(gpuTiming.milliseconds);
+            s_gpuRenderPassHistory.Push(gpuTiming.renderPassMilliseconds);
+
+            if(!s_paused)
+                s_lastGpuTiming = gpuTiming;
+        }
+    }
+
+    void Profiler::RenderGUI() {
+        if(ImGui::Begin("Profiler")) {
+            FramePercentiles cpu = s_cpuFrameHistory.GetPercentiles();
+            ImGui::Text("CPU frame: %.2f ms, p50 %.2f, p95 %.2f, p99 %.2f", s_lastFrameMilliseconds, cpu.p50, cpu.p95, cpu.p99);
+
+            if(s_gpuFrameHistory.GetSamples().empty())
+                ImGui::TextUnformatted("GPU frame: timestamps unsupported");
+            else {
+                FramePercentiles gpu = s_gpuFrameHistory.GetPercentiles();
+                FramePercentiles renderPass = s_gpuRenderPassHistory.GetPercentiles();
+                ImGui::Text("GPU frame: %.2f ms, p50 %.2f, p95 %.2f, p99 %.2f", s_lastGpuTiming.milliseconds, gpu.p50, gpu.p95, gpu.p99);
+                ImGui::Text("GPU render pass: %.2f ms, p50 %.2f, p95 %.2f, p99 %.2f", s_lastGpuTiming.renderPassMilliseconds,
+                            renderPass.p50, renderPass.p95, renderPass.p99);
+            }
+
+            std::span<const f32> samples = s_cpuFrameHistory.GetSamples();
+            ImGui::PlotLines("##CPU frame times", samples.data(), (i32)samples.size(), (i32)s_cpuFrameHistory.GetOffset(),
+                             "CPU frame ms", 0.f, FLT_MAX, ImVec2(0, 60));
+
+            ImGui::Checkbox("Pause", &s_paused);
+            ImGui::SameLine();
+            ImGui::Text("%llu events, %llu dropped", (u64)s_lastEvents.size(), s_lastDroppedCount);
+
+            RenderTimeline();
+        }
+        ImGui::End();
+    }
+
+    void Profiler::RecordEvent(const char* name, std::chrono::high_resolution_clock::time_point start,
+                               std::chrono::high_resolution_clock::time_point end, u32 depth) {
+        u32 threadIndex = GetThreadIndex();
+
+        std::lock_guard lock(s_mutex);
+        if(s_events.size() >= MAX_EVENTS_PER_FRAME) {
+            s_droppedCount++;
+            return;
+        }
+
+        s_events.push_back({name, ToMilliseconds(start - s_frameStart), ToMilliseconds(end - start), threadIndex, depth});
+    }
+
+    u32 Profiler::GetThreadIndex() {
+        if(t_threadIndex == ~0u)
+            t_threadIndex = s_threadCount++;
+        return t_threadIndex;
+    }
+
+    void Profiler::RenderTimeline() {
+        constexpr f32 ROW_HEIGHT = 18.f;
+        constexpr f32 LABEL_WIDTH = 80.f;
+
+        // One lane per thread that ended a scope, the main thread first, each as deep as its deepest scope
+        std::map<u32, u32> laneDepths;
+        for(const ProfileEvent& event : s_lastEvents)
+            laneDepths[event.threadIndex] = std::max(laneDepths[event.threadIndex], event.depth + 1);
+
+        std::vector<std::pair<u32, u32>> lanes(laneDepths.begin(), laneDepths.end());
+        std::ranges::stable_partition(lanes, [](const std::pair<u32, u32>& lane) { return lane.first == s_mainThreadIndex; });
+
+        f32 timelineMilliseconds = std::max({s_lastFrameMilliseconds, s_lastGpuTiming.milliseconds, 0.001f});
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        f32 width = std::max(ImGui::GetContentRegionAvail().x - LABEL_WIDTH, 1.f);
+        f32 scale = width / timelineMilliseconds;
+        f32 y = origin.y;
+
+        auto drawBar = [&](const char* name, f32 start, f32 duration, f32 top) {
+            f32 x0 = origin.x + LABEL_WIDTH + std::max(start, 0.f) * scale;
+            f32 x1 = origin.x + LABEL_WIDTH + std::min(start + duration, timelineMilliseconds) * scale;
+            ImVec2 min = {x0, top};
+            ImVec2 max = {std::max(x1, x0 + 1.f), top + ROW_HEIGHT - 1.f};
+
+            drawList->AddRectFilled(min, max, GetEventColor(name));
+            if(max.x - min.x > ImGui::CalcTextSize(name).x + 4.f)
+                drawList->AddText({min.x + 2.f, min.y + 2.f}, IM_COL32_WHITE, name);
+
+            if(ImGui::IsMouseHoveringRect(min, max))
+                ImGui::SetTooltip("%s\n%.3f ms", name, duration);
+        };
+
+        for(auto [threadIndex, depth] : lanes) {
+            std::string label = threadIndex == s_mainThreadIndex ? "Main" : std::format("Thread {}", threadIndex);
+            drawList->AddText({origin.x, y + 2.f}, IM_COL32_WHITE, label.c_str());
+
+            for(const ProfileEvent& event : s_lastEvents)
+                if(event.threadIndex == threadIndex)
+                    drawBar(event.name, event.startMilliseconds, event.durationMilliseconds, y + (f32)event.depth * ROW_HEIGHT);
+
+            y += (f32)depth * ROW_HEIGHT + 4.f;
+        }
+
+        // GPU timestamps have their own clock, the lane starts with the frame's command buffer rather than lining up with the CPU
+        if(s_lastGpuTiming.milliseconds >= 0) {
+            drawList->AddText({origin.x, y + 2.f}, IM_COL32_WHITE, "GPU");
+            drawBar("GPU frame", 0.f, s_lastGpuTiming.milliseconds, y);
+            drawBar("Uploads", 0.f, s_lastGpuTiming.uploadMilliseconds, y + ROW_HEIGHT);
+            drawBar("Render pass", s_lastGpuTiming.uploadMilliseconds, s_lastGpuTiming.renderPassMilliseconds, y + ROW_HEIGHT);
+            y += 2.f * ROW_HEIGHT + 4.f;
+        }
+
+        ImGui::Dummy({LABEL_WIDTH + width, y - origin.y});
+    }
+
+    ProfileScope::ProfileScope(const char* name)
+        : m_name(name), m_depth(t_depth++), m_start(std::chrono::high_resolution_clock::now()) {}
+
+    ProfileScope::~ProfileScope() {
+        t_depth--;
+        Profiler::RecordEvent(m_name, m_start, std::chrono::high_resolution_clock::now(), m_depth);
+    }
+}
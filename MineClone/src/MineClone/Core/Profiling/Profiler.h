@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "MineClone/Core/Renderer/RendererTypes.h"
+
+#define MC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define MC_PROFILE_CONCAT(a, b) MC_PROFILE_CONCAT_IMPL(a, b)
+
+#ifndef APP_DISTRIBUTION
+    // Times the rest of the enclosing block as one event of the current Profiler frame, name must outlive the frame
+    #define MC_PROFILE_SCOPE(name) ::mc::ProfileScope MC_PROFILE_CONCAT(mcProfileScope, __LINE__){name}
+#else
+    #define MC_PROFILE_SCOPE(name)
+#endif
+
+namespace mc
+{
+    struct ProfileEvent
+    {
+        const char* name;
+        // Relative to the start of the frame the scope ended in, negative for scopes that began in an earlier frame
+        f32 startMilliseconds;
+        f32 durationMilliseconds;
+        u32 threadIndex;
+        // Scopes open on the same thread when this one began
+        u32 depth;
+    };
+
+    struct FramePercentiles
+    {
+        f32 p50 = 0;
+        f32 p95 = 0;
+        f32 p99 = 0;
+    };
+
+    // Last SIZE samples of a per frame time, oldest overwritten first
+    class FrameHistory
+    {
+    public:
+        static constexpr u32 SIZE = 240;
+
+    public:
+        void Push(f32 milliseconds);
+        FramePercentiles GetPercentiles() const;
+
+        // Ring buffer order, the oldest sample sits at GetOffset once the history is full
+        std::span<const f32> GetSamples() const { return std::span(m_samples).first(m_count); }
+        u32 GetOffset() const { return m_count < SIZE ? 0 : m_next; }
+
+    private:
+        std::array<f32, SIZE> m_samples{};
+        u32 m_count = 0;
+        u32 m_next = 0;
+    };
+
+    // Collects MC_PROFILE_SCOPE events from every thread per frame and keeps rolling CPU and GPU frame times.
+    // Events land in the frame they end in, the overlay shows the last completed frame.
+    class Profiler
+    {
+    public:
+        // Closes the frame recorded so far, call once per frame on the main thread
+        static void BeginFrame();
+        static void RenderGUI();
+
+        static void RecordEvent(const char* name, std::chrono::high_resolution_clock::time_point start,
+                                std::chrono::high_resolution_clock::time_point end, u32 depth);
+
+    public:
+        static const FrameHistory& GetCpuFrameHistory() { return s_cpuFrameHistory; }
+        static const FrameHistory& GetGpuFrameHistory() { return s_gpuFrameHistory; }
+        static const FrameHistory& GetGpuRenderPassHistory() { return s_gpuRenderPassHistory; }
+
+    private:
+        static u32 GetThreadIndex();
+
+        static void RenderTimeline();
+
+    private:
+        // Bounds the memory of frames with a lot of worker activity, the rest is counted as dropped
+        static constexpr u32 MAX_EVENTS_PER_FRAME = 4096;
+
+        inline static std::mutex s_mutex;
+        inline static std::vector<ProfileEvent> s_events;
+        inline static u64 s_droppedCount = 0;
+        inline static std::chrono::high_resolution_clock::time_point s_frameStart = std::chrono::high_resolution_clock::now();
+
+        // Last completed frame as shown by the overlay, kept while paused
+        inline static std::vector<ProfileEvent> s_lastEvents;
+        inline static f32 s_lastFrameMilliseconds = 0;
+        inline static u64 s_lastDroppedCount = 0;
+        inline static GpuFrameTiming s_lastGpuTiming;
+        inline static bool s_paused = false;
+
+        inline static FrameHistory s_cpuFrameHistory;
+        inline static FrameHistory s_gpuFrameHistory;
+        inline static FrameHistory s_gpuRenderPassHistory;
+        inline static u64 s_frameCount = 0;
+        inline static u64 s_lastGpuFrameIndex = ~0ull;
+
+        inline static std::atomic<u32> s_threadCount = 0;
+        inline static u32 s_mainThreadIndex = 0;
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name);
+        ~ProfileScope();
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        u32 m_depth;
+        std::chrono::high_resolution_clock::time_point m_start;
+    };
+}
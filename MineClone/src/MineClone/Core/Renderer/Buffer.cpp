@@ -4,6 +4,7 @@
 #include "VulkanTypes.h"
 #include "RendererAPI.h"
 #include "VulkanUtils.h"
+#include "DeletionQueue.h"
 
 namespace mc
 {
@@ -19,26 +20,10 @@ namespace mc
 
     void Buffer::Delete()
     {
-        struct Deleter
-        {
-            VkBuffer buffer;
-            VkDeviceMemory memory;
-            
-            void operator()() const {
-                auto& state = RendererAPI::GetState();
-                if(buffer)
-                    vkDestroyBuffer(state.device, buffer, state.allocator);
-
-                if(memory)
-                    vkFreeMemory(state.device, memory, state.allocator); 
-            }
-        };
-        
-        if(buffer || memory)
-            RendererAPI::SubmitAfterFrame(Deleter{buffer, memory});
+        DeletionQueue::Push(buffer, allocation);
 
         buffer = nullptr;
-        memory = nullptr;
+        allocation = {};
         mappedMemory = nullptr;
     }
 
@@ -61,28 +46,17 @@ namespace mc
         VkMemoryRequirements memRequirements;
         vkGetBufferMemoryRequirements(state.device, buffer->buffer, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = memRequirements.size,
-            .memoryTypeIndex = details::VulkanUtils::FindMemoryType(memRequirements.memoryTypeBits, properties),
-        };
+        buffer->allocation = MemoryAllocator::Allocate(memRequirements, properties);
+        buffer->mappedMemory = buffer->allocation.mappedMemory;
 
-        if(vkAllocateMemory(state.device, &allocInfo, state.allocator, &buffer->memory) != VK_SUCCESS)
-            throw std::runtime_error("failed to allocate vertex buffer memory!");
-
-        vkBindBufferMemory(state.device, buffer->buffer, buffer->memory, 0);
+        vkBindBufferMemory(state.device, buffer->buffer, buffer->allocation.memory, buffer->allocation.offset);
 
         return buffer;
     }
     
     Ref<Buffer> Buffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, const void* data) {
-        auto& state = RendererAPI::GetState();
         Ref<Buffer> buffer = CreateBuffer(size, usage, properties);
-
-        vkMapMemory(state.device, buffer->memory, 0, size, 0, &buffer->mappedMemory);
         memcpy(buffer->mappedMemory, data, size);
-        vkUnmapMemory(state.device, buffer->memory);
-        buffer->mappedMemory = nullptr;
 
         return buffer;
     }
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include "MemoryAllocator.h"
+
 namespace mc
 {
     class Buffer
@@ -26,8 +28,9 @@ namespace mc
         
     private:
         VkBuffer buffer = VK_NULL_HANDLE;
-        VkDeviceMemory memory = VK_NULL_HANDLE;
+        MemoryAllocation allocation;
 
+        // Host visible buffers stay mapped, points into their persistently mapped memory block
         void* mappedMemory = nullptr;
 
     private:
@@ -36,6 +39,8 @@ namespace mc
         
         friend class RendererAPI;
         friend class Material;
+        friend class StagingRing;
+        friend class GeometryArena;
     };
 }
 
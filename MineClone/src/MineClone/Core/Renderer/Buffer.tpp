@@ -2,6 +2,7 @@
 #include "Buffer.h"
 
 #include "RendererAPI.h"
+#include "StagingRing.h"
 
 namespace mc
 {
@@ -9,11 +10,11 @@ namespace mc
     Ref<Buffer> Buffer::CreateVertexBuffer(std::span<Vertex> data) {
         u64 size = sizeof(Vertex) * data.size();
 
-        auto stageBuffer = CreateStageBuffer(size, data.data());
+        StagingAllocation staging = StagingRing::Write(data.data(), size);
 
         auto vertexBuffer = CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        RendererAPI::CopyBuffer(stageBuffer, vertexBuffer, size);
+        RendererAPI::CopyBuffer(staging.buffer, vertexBuffer, size, staging.offset);
 
         return vertexBuffer;
     }
@@ -22,11 +23,11 @@ namespace mc
     Ref<Buffer> Buffer::CreateIndexBuffer(std::span<Index> data) {
         u64 size = sizeof(Index) * data.size();
 
-        auto stageBuffer = CreateStageBuffer(size, data.data());
+        StagingAllocation staging = StagingRing::Write(data.data(), size);
 
         auto vertexBuffer = CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        RendererAPI::CopyBuffer(stageBuffer, vertexBuffer, size);
+        RendererAPI::CopyBuffer(staging.buffer, vertexBuffer, size, staging.offset);
 
         return vertexBuffer;
     }
@@ -0,0 +1,117 @@
+﻿#include "mcpch.h"
+#include "DeletionQueue.h"
+
+#include "RendererAPI.h"
+
+namespace mc
+{
+    template<typename T>
+    static void AppendAndClear(std::vector<T>& target, std::vector<T>& source) {
+        target.insert(target.end(), source.begin(), source.end());
+        source.clear();
+    }
+
+    void DeletionQueue::Push(VkBuffer buffer, const MemoryAllocation& allocation) {
+        if(buffer || allocation.IsValid())
+            s_pending.buffers.push_back({buffer, allocation});
+    }
+
+    void DeletionQueue::Push(VkImage image, VkDeviceMemory memory) {
+        if(image || memory)
+            s_pending.images.push_back({image, memory});
+    }
+
+    void DeletionQueue::Push(VkImageView imageView) {
+        if(imageView)
+            s_pending.imageViews.push_back(imageView);
+    }
+
+    void DeletionQueue::Push(VkSampler sampler) {
+        if(sampler)
+            s_pending.samplers.push_back(sampler);
+    }
+
+    void DeletionQueue::Push(const GeometryAllocation& allocation) {
+        if(allocation.IsValid())
+            s_nextFrameRanges.push_back(allocation);
+    }
+
+    void DeletionQueue::BeginFrame() {
+        AppendAndClear(s_pending.geometryRanges, s_nextFrameRanges);
+    }
+
+    void DeletionQueue::RetireFrame(u32 frameIndex) {
+        s_frames[frameIndex].Append(s_pending);
+    }
+
+    void DeletionQueue::FlushFrame(u32 frameIndex) {
+        s_frames[frameIndex].Flush();
+    }
+
+    void DeletionQueue::FlushAll() {
+        BeginFrame();
+        for(Batch& batch : s_frames)
+            batch.Flush();
+        s_pending.Flush();
+    }
+
+    DeletionStats DeletionQueue::GetStats() {
+        DeletionStats stats;
+        s_pending.AddStats(stats);
+        for(const Batch& batch : s_frames)
+            batch.AddStats(stats);
+        stats.geometryRangeCount += s_nextFrameRanges.size();
+        return stats;
+    }
+
+    void DeletionQueue::Batch::Append(Batch& other) {
+        AppendAndClear(buffers, other.buffers);
+        AppendAndClear(images, other.images);
+        AppendAndClear(imageViews, other.imageViews);
+        AppendAndClear(samplers, other.samplers);
+        AppendAndClear(geometryRanges, other.geometryRanges);
+    }
+
+    void DeletionQueue::Batch::Flush() {
+        auto& state = RendererAPI::GetState();
+
+        for(const BufferDeletion& deletion : buffers) {
+            if(deletion.buffer)
+                vkDestroyBuffer(state.device, deletion.buffer, state.allocator);
+            MemoryAllocator::Free(deletion.allocation);
+        }
+
+        for(const ImageDeletion& deletion : images) {
+            vkDestroyImage(state.device, deletion.image, state.allocator);
+            vkFreeMemory(state.device, deletion.memory, state.allocator);
+        }
+
+        for(VkImageView imageView : imageViews)
+            vkDestroyImageView(state.device, imageView, state.allocator);
+
+        for(VkSampler sampler : samplers)
+            vkDestroySampler(state.device, sampler, state.allocator);
+
+        for(const GeometryAllocation& allocation : geometryRanges)
+            GeometryArena::Release(allocation);
+
+        s_deletedCount += buffers.size() + images.size() + imageViews.size() + samplers.size() + geometryRanges.size();
+
+        buffers.clear();
+        images.clear();
+        imageViews.clear();
+        samplers.clear();
+        geometryRanges.clear();
+    }
+
+    void DeletionQueue::Batch::AddStats(DeletionStats& stats) const {
+        stats.bufferCount += buffers.size();
+        for(const BufferDeletion& deletion : buffers)
+            stats.bufferBytes += deletion.allocation.size;
+
+        stats.imageCount += images.size();
+        stats.imageViewCount += imageViews.size();
+        stats.samplerCount += samplers.size();
+        stats.geometryRangeCount += geometryRanges.size();
+    }
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "GeometryArena.h"
+#include "MemoryAllocator.h"
+#include "VulkanTypes.h"
+
+namespace mc
+{
+    // Handles waiting in the DeletionQueue
+    struct DeletionStats
+    {
+        u64 bufferCount = 0;
+        u64 bufferBytes = 0;
+        u64 imageCount = 0;
+        u64 imageViewCount = 0;
+        u64 samplerCount = 0;
+        u64 geometryRangeCount = 0;
+
+        u64 GetCount() const { return bufferCount + imageCount + imageViewCount + samplerCount + geometryRangeCount; }
+    };
+
+    // Defers destruction of GPU resources until no frame in flight can use them anymore. Handles are kept in typed
+    // arrays per frame instead of closures, the arrays keep their capacity so a steady stream of deletions does not
+    // allocate. Everything pushed is retired with the frame submitted next and destroyed once its fence signaled.
+    // Main thread only.
+    class DeletionQueue
+    {
+    public:
+        static void Push(VkBuffer buffer, const MemoryAllocation& allocation);
+        static void Push(VkImage image, VkDeviceMemory memory);
+        static void Push(VkImageView imageView);
+        static void Push(VkSampler sampler);
+        // Copies into the range may still be queued, those are recorded by the next BeginFrame so the range
+        // is held back until that frame is retired
+        static void Push(const GeometryAllocation& allocation);
+
+        // Called when the next frame's uploads are recorded / after frameIndex was submitted / once its fence signaled
+        static void BeginFrame();
+        static void RetireFrame(u32 frameIndex);
+        static void FlushFrame(u32 frameIndex);
+
+        // Destroys everything right away, the device must be idle
+        static void FlushAll();
+
+    public:
+        static DeletionStats GetStats();
+        // Handles destroyed since startup
+        static u64 GetDeletedCount() { return s_deletedCount; }
+
+    private:
+        struct BufferDeletion
+        {
+            VkBuffer buffer;
+            MemoryAllocation allocation;
+        };
+
+        struct ImageDeletion
+        {
+            VkImage image;
+            VkDeviceMemory memory;
+        };
+
+        struct Batch
+        {
+            std::vector<BufferDeletion> buffers;
+            std::vector<ImageDeletion> images;
+            std::vector<VkImageView> imageViews;
+            std::vector<VkSampler> samplers;
+            std::vector<GeometryAllocation> geometryRanges;
+
+            // Moves the handles of other to the back of this batch, keeping the capacity of both
+            void Append(Batch& other);
+            void Flush();
+            void AddStats(DeletionStats& stats) const;
+        };
+
+    private:
+        // Pushed since the last submit
+        inline static Batch s_pending;
+        // Arena ranges waiting for the copies the next BeginFrame records
+        inline static std::vector<GeometryAllocation> s_nextFrameRanges;
+        inline static std::array<Batch, FrameData::MAX_FRAMES_IN_FLIGHT> s_frames;
+
+        inline static u64 s_deletedCount = 0;
+    };
+}
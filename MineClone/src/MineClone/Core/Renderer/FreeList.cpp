@@ -0,0 +1,70 @@
+﻿#include "mcpch.h"
+#include "FreeList.h"
+
+namespace mc
+{
+    FreeList::FreeList(u64 size)
+        : m_size(size) {
+        if(size > 0)
+            m_freeRanges.emplace(0, size);
+    }
+
+    bool FreeList::TryAllocate(u64 size, u64 alignment, u64& outOffset) {
+        for(auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it) {
+            auto [rangeOffset, rangeSize] = *it;
+
+            u64 offset = (rangeOffset + alignment - 1) / alignment * alignment;
+            u64 rangeEnd = rangeOffset + rangeSize;
+            if(offset + size > rangeEnd)
+                continue;
+
+            // Alignment padding stays free in front, the remainder goes back behind the allocation
+            m_freeRanges.erase(it);
+            if(offset > rangeOffset)
+                m_freeRanges.emplace(rangeOffset, offset - rangeOffset);
+            if(offset + size < rangeEnd)
+                m_freeRanges.emplace(offset + size, rangeEnd - (offset + size));
+
+            m_usedSize += size;
+            outOffset = offset;
+            return true;
+        }
+
+        return false;
+    }
+
+    void FreeList::Release(u64 offset, u64 size) {
+        m_usedSize -= size;
+
+        auto next = m_freeRanges.lower_bound(offset);
+
+        // Merge with the range right behind
+        if(next != m_freeRanges.end() && offset + size == next->first) {
+            size += next->second;
+            next = m_freeRanges.erase(next);
+        }
+
+        // Merge with the range right in front
+        if(next != m_freeRanges.begin()) {
+            auto prev = std::prev(next);
+            if(prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+
+        m_freeRanges.emplace_hint(next, offset, size);
+    }
+
+    f32 FreeList::GetFragmentation() const {
+        u64 freeSize = m_size - m_usedSize;
+        if(freeSize == 0)
+            return 0.f;
+
+        u64 largest = 0;
+        for(auto [offset, size] : m_freeRanges)
+            largest = std::max(largest, size);
+
+        return 1.f - (f32)largest / (f32)freeSize;
+    }
+}
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Offset ordered list of the free ranges of a linear address space, used to sub-allocate memory blocks and buffers.
+    // First fit allocation, neighbouring ranges are coalesced on release.
+    class FreeList
+    {
+    public:
+        explicit FreeList(u64 size);
+
+        // Returns false when no free range can hold size units at the given alignment
+        bool TryAllocate(u64 size, u64 alignment, u64& outOffset);
+        void Release(u64 offset, u64 size);
+
+    public:
+        bool IsEmpty() const { return m_usedSize == 0; }
+
+        u64 GetSize() const { return m_size; }
+        u64 GetUsedSize() const { return m_usedSize; }
+        // Largest free range relative to all free space, 0 when it is one contiguous range
+        f32 GetFragmentation() const;
+
+        const std::map<u64, u64>& GetFreeRanges() const { return m_freeRanges; }
+
+    private:
+        u64 m_size;
+        u64 m_usedSize = 0;
+        std::map<u64, u64> m_freeRanges;
+    };
+}
@@ -0,0 +1,97 @@
+﻿#include "mcpch.h"
+#include "Frustum.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+    #define MC_FRUSTUM_SSE 1
+#endif
+
+namespace mc
+{
+    Frustum::Frustum(const Mat4& viewProjection) {
+        // Gribb/Hartmann, glm matrices are column major so rows are gathered across columns
+        float4 rows[4];
+        for(i32 i = 0; i < 4; i++)
+            rows[i] = {viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+
+        m_planes = {
+            rows[3] + rows[0], // Left
+            rows[3] - rows[0], // Right
+            rows[3] + rows[1], // Bottom
+            rows[3] - rows[1], // Top
+            rows[2],           // Near, Vulkan clips depth to [0, 1] so this is row 2 alone
+            rows[3] - rows[2], // Far
+        };
+
+        for(float4& plane : m_planes)
+            plane /= length(float3(plane));
+    }
+
+    bool Frustum::IntersectsAABB(float3 min, float3 max) const {
+        float3 center = (min + max) * 0.5f;
+        float3 halfExtent = (max - min) * 0.5f;
+
+        for(const float4& plane : m_planes) {
+            float3 normal = float3(plane);
+            if(dot(normal, center) + plane.w + dot(abs(normal), halfExtent) < 0.f)
+                return false;
+        }
+
+        return true;
+    }
+
+    void Frustum::CullBoxes(std::span<const f32> centerX, std::span<const f32> centerY, std::span<const f32> centerZ,
+                            float3 halfExtent, std::span<u8> outVisible) const {
+        u64 count = outVisible.size();
+        u64 i = 0;
+
+#if MC_FRUSTUM_SSE
+        // All boxes share their extent, so the projected radius is constant per plane
+        __m128 nx[6], ny[6], nz[6], offset[6];
+        for(i32 p = 0; p < 6; p++) {
+            const float4& plane = m_planes[p];
+            nx[p] = _mm_set1_ps(plane.x);
+            ny[p] = _mm_set1_ps(plane.y);
+            nz[p] = _mm_set1_ps(plane.z);
+            offset[p] = _mm_set1_ps(plane.w + dot(abs(float3(plane)), halfExtent));
+        }
+
+        __m128 zero = _mm_setzero_ps();
+        for(; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(&centerX[i]);
+            __m128 y = _mm_loadu_ps(&centerY[i]);
+            __m128 z = _mm_loadu_ps(&centerZ[i]);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for(i32 p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)),
+                                             _mm_add_ps(_mm_mul_ps(nz[p], z), offset[p]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+            }
+
+            i32 mask = _mm_movemask_ps(inside);
+            for(i32 lane = 0; lane < 4; lane++)
+                outVisible[i + lane] = (u8)((mask >> lane) & 1);
+        }
+#endif
+
+        if(i < count)
+            CullBoxesScalar(centerX.subspan(i), centerY.subspan(i), centerZ.subspan(i), halfExtent, outVisible.subspan(i));
+    }
+
+    void Frustum::CullBoxesScalar(std::span<const f32> centerX, std::span<const f32> centerY, std::span<const f32> centerZ,
+                                  float3 halfExtent, std::span<u8> outVisible) const {
+        std::array<f32, 6> offsets;
+        for(i32 p = 0; p < 6; p++)
+            offsets[p] = m_planes[p].w + dot(abs(float3(m_planes[p])), halfExtent);
+
+        for(u64 i = 0; i < outVisible.size(); i++) {
+            bool inside = true;
+            for(i32 p = 0; p < 6 && inside; p++) {
+                const float4& plane = m_planes[p];
+                inside = (plane.x * centerX[i] + plane.y * centerY[i]) + (plane.z * centerZ[i] + offsets[p]) >= 0.f;
+            }
+            outVisible[i] = inside;
+        }
+    }
+}
@@ -0,0 +1,28 @@
+﻿#pragma once
+
+namespace mc
+{
+    // View frustum as six inward facing planes (xyz normal, w distance) extracted from a projection * view matrix.
+    class Frustum
+    {
+    public:
+        Frustum() = default;
+        explicit Frustum(const Mat4& viewProjection);
+
+    public:
+        bool IntersectsAABB(float3 min, float3 max) const;
+
+        // Tests equally sized boxes given by their centers in SoA layout, 4 at a time with SSE.
+        // Writes 1 to outVisible for every box at least partially inside, 0 otherwise.
+        void CullBoxes(std::span<const f32> centerX, std::span<const f32> centerY, std::span<const f32> centerZ,
+                       float3 halfExtent, std::span<u8> outVisible) const;
+        // Reference implementation of CullBoxes testing one box at a time
+        void CullBoxesScalar(std::span<const f32> centerX, std::span<const f32> centerY, std::span<const f32> centerZ,
+                             float3 halfExtent, std::span<u8> outVisible) const;
+
+        const std::array<float4, 6>& GetPlanes() const { return m_planes; }
+
+    private:
+        std::array<float4, 6> m_planes{};
+    };
+}
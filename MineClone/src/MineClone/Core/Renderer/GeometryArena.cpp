@@ -0,0 +1,52 @@
+﻿#include "mcpch.h"
+#include "GeometryArena.h"
+
+#include "Buffer.h"
+#include "DeletionQueue.h"
+#include "RendererAPI.h"
+#include "StagingRing.h"
+
+namespace mc
+{
+    void GeometryArena::Init(u64 size) {
+        u64 quadCapacity = size / QUAD_SIZE;
+
+        s_buffer = Buffer::CreateBuffer(quadCapacity * QUAD_SIZE, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        s_freeList = FreeList(quadCapacity);
+        s_failedCount = 0;
+    }
+
+    void GeometryArena::Deinit() {
+        s_buffer->Delete();
+        s_buffer = nullptr;
+        s_freeList = FreeList(0);
+    }
+
+    GeometryAllocation GeometryArena::Upload(std::span<const ChunkVertex> vertices) {
+        u32 quadCount = (u32)vertices.size() / 4;
+        if(quadCount == 0)
+            return {};
+
+        u64 firstQuad;
+        if(!s_freeList.TryAllocate(quadCount, 1, firstQuad)) {
+            s_failedCount++;
+            return {};
+        }
+
+        u64 size = quadCount * QUAD_SIZE;
+        StagingAllocation staging = StagingRing::Write(vertices.data(), size);
+        RendererAPI::CopyBuffer(staging.buffer, s_buffer, size, staging.offset, firstQuad * QUAD_SIZE);
+
+        return {(u32)firstQuad, quadCount};
+    }
+
+    void GeometryArena::Free(const GeometryAllocation& allocation) {
+        DeletionQueue::Push(allocation);
+    }
+
+    void GeometryArena::Release(const GeometryAllocation& allocation) {
+        if(s_buffer)
+            s_freeList.Release(allocation.firstQuad, allocation.quadCount);
+    }
+}
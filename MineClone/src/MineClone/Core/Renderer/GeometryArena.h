@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include "FreeList.h"
+#include "MineClone/Config.h"
+
+namespace mc
+{
+    class Buffer;
+
+    // Quads of one chunk mesh inside the GeometryArena
+    struct GeometryAllocation
+    {
+        u32 firstQuad = 0;
+        u32 quadCount = 0;
+
+        bool IsValid() const { return quadCount > 0; }
+    };
+
+    // One large device local vertex buffer all chunk meshes are placed in, so every chunk can be drawn
+    // with a single indirect draw without rebinding vertex buffers. Space is handed out in quads of
+    // 4 ChunkVertex from a FreeList. Main thread only.
+    class GeometryArena
+    {
+    public:
+        static void Init(u64 size);
+        static void Deinit();
+
+        // Stages vertices into a fresh range, returns an invalid allocation when the arena has no room left
+        static GeometryAllocation Upload(std::span<const ChunkVertex> vertices);
+
+        // Copies into the range may still be queued and frames in flight may draw it, the range is
+        // released once the frame that records the last of those copies completed
+        static void Free(const GeometryAllocation& allocation);
+
+    public:
+        static const Ref<Buffer>& GetBuffer() { return s_buffer; }
+
+        static u64 GetCapacity() { return s_freeList.GetSize(); }
+        static u64 GetUsedQuads() { return s_freeList.GetUsedSize(); }
+        static f32 GetFragmentation() { return s_freeList.GetFragmentation(); }
+        // Uploads that did not fit and were left to the caller's fallback
+        static u64 GetFailedCount() { return s_failedCount; }
+
+    private:
+        static constexpr u64 QUAD_SIZE = sizeof(ChunkVertex) * 4;
+
+        // Called by the DeletionQueue once no frame can touch the range anymore
+        static void Release(const GeometryAllocation& allocation);
+
+        inline static Ref<Buffer> s_buffer;
+        inline static FreeList s_freeList{0};
+        inline static u64 s_failedCount = 0;
+
+        friend class DeletionQueue;
+    };
+}
@@ -4,6 +4,7 @@
 #include "RendererAPI.h"
 #include "VulkanTypes.h"
 #include "VulkanUtils.h"
+#include "MineClone/Core/Threading/JobSystem.h"
 
 namespace mc
 {
@@ -11,7 +12,7 @@ namespace mc
         auto& state = RendererAPI::GetState();
 
         VkDescriptorSetLayout descriptorSetLayout;
-        VkDescriptorSet descriptorSet;
+        std::vector<VkDescriptorSet> descriptorSets;
         VkPipeline pipeline;
         VkPipelineLayout pipelineLayout;
 
@@ -32,7 +33,16 @@ namespace mc
                 .pImmutableSamplers = nullptr,
             };
 
-            std::array bindings = {uboLayoutBinding, samplerLayoutBinding};
+            // Per draw data of RendererAPI::DrawQuadsIndirect, indexed by gl_InstanceIndex
+            VkDescriptorSetLayoutBinding drawDataLayoutBinding = {
+                .binding = 2,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                .pImmutableSamplers = nullptr,
+            };
+
+            std::array bindings = {uboLayoutBinding, samplerLayoutBinding, drawDataLayoutBinding};
             VkDescriptorSetLayoutCreateInfo layoutInfo{
                 .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
                 .bindingCount = static_cast<u32>(bindings.size()),
@@ -51,8 +61,12 @@ namespace mc
             };
 
             for(FrameData& frame : state.frames) {
-                if(vkAllocateDescriptorSets(state.device, &allocInfo, &descriptorSet) != VK_SUCCESS)
-                    throw std::runtime_error("failed to allocate descriptor sets!");
+                VkDescriptorSet descriptorSet;
+                {
+                    std::lock_guard lock(s_descriptorPoolMutex);
+                    if(vkAllocateDescriptorSets(state.device, &allocInfo, &descriptorSet) != VK_SUCCESS)
+                        throw std::runtime_error("failed to allocate descriptor sets!");
+                }
 
                 VkDescriptorBufferInfo bufferInfo = {
                     .buffer = frame.uboBuffer->buffer,
@@ -60,19 +74,37 @@ namespace mc
                     .range = sizeof(UniformBufferObject),
                 };
 
-                VkWriteDescriptorSet descriptorWrite = {
-                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                    .dstSet = descriptorSet,
-                    .dstBinding = 0,
-                    .dstArrayElement = 0,
-                    .descriptorCount = 1,
-                    .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                    .pImageInfo = nullptr,
-                    .pBufferInfo = &bufferInfo,
-                    .pTexelBufferView = nullptr,
+                VkDescriptorBufferInfo drawDataInfo = {
+                    .buffer = frame.drawDataBuffer->buffer,
+                    .offset = 0,
+                    .range = VK_WHOLE_SIZE,
+                };
+
+                std::array descriptorWrites = {
+                    VkWriteDescriptorSet{
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = descriptorSet,
+                        .dstBinding = 0,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                        .pImageInfo = nullptr,
+                        .pBufferInfo = &bufferInfo,
+                        .pTexelBufferView = nullptr,
+                    },
+                    VkWriteDescriptorSet{
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = descriptorSet,
+                        .dstBinding = 2,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                        .pBufferInfo = &drawDataInfo,
+                    },
                 };
 
-                vkUpdateDescriptorSets(state.device, 1, &descriptorWrite, 0, nullptr);
+                vkUpdateDescriptorSets(state.device, (u32)descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+                descriptorSets.push_back(descriptorSet);
             }
 
             // Graphics Pipeline
@@ -244,18 +276,39 @@ namespace mc
                 .basePipelineIndex = -1, // Optional
             };
 
-            if(vkCreateGraphicsPipelines(state.device, VK_NULL_HANDLE, 1, &pipelineInfo, state.allocator, &pipeline) != VK_SUCCESS)
+            if(vkCreateGraphicsPipelines(state.device, state.pipelineCache, 1, &pipelineInfo, state.allocator, &pipeline) != VK_SUCCESS)
                 throw std::runtime_error("failed to create graphics pipeline!");
 
             vkDestroyShaderModule(state.device, fragShaderModule, state.allocator);
             vkDestroyShaderModule(state.device, vertShaderModule, state.allocator);
         }
 
-        return CreateRef(new Material(descriptorSetLayout, descriptorSet, pipeline, pipelineLayout));
+        return CreateRef(new Material(descriptorSetLayout, std::move(descriptorSets), pipeline, pipelineLayout));
+    }
+
+    std::vector<Ref<Material>> Material::Create(std::span<const CreateInfo> createInfos) {
+        std::vector<Ref<Material>> materials(createInfos.size());
+        std::vector<std::exception_ptr> errors(createInfos.size());
+
+        // Pipeline compilation dominates, the pipeline cache may be used by several threads at once
+        JobSystem::ParallelFor((u32)createInfos.size(), [&](u32 index) {
+            try {
+                materials[index] = Create(createInfos[index].name, createInfos[index].vertexDescription);
+            }
+            catch(...) {
+                errors[index] = std::current_exception();
+            }
+        });
+
+        for(const std::exception_ptr& error : errors)
+            if(error)
+                std::rethrow_exception(error);
+
+        return materials;
     }
 
-    Material::Material(VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet descriptorSet, VkPipeline pipeline, VkPipelineLayout pipelineLayout)
-        : m_descriptorSetLayout(descriptorSetLayout), m_descriptorSet(descriptorSet), m_pipeline(pipeline), m_pipelineLayout(pipelineLayout) {}
+    Material::Material(VkDescriptorSetLayout descriptorSetLayout, std::vector<VkDescriptorSet> descriptorSets, VkPipeline pipeline, VkPipelineLayout pipelineLayout)
+        : m_descriptorSetLayout(descriptorSetLayout), m_descriptorSets(std::move(descriptorSets)), m_pipeline(pipeline), m_pipelineLayout(pipelineLayout) {}
 
     Material::~Material() {
         auto& state = RendererAPI::GetState();
@@ -268,12 +321,12 @@ namespace mc
 
     void Material::Bind() {
         auto& state = RendererAPI::GetState();
-        auto& frame = state.GetCurrentFrame();
+        VkCommandBuffer commandBuffer = RendererAPI::GetRecordingCommandBuffer();
 
         state.currentMaterial = shared_from_this();
 
-        vkCmdBindPipeline(frame.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
-        vkCmdBindDescriptorSets(frame.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSets[state.currentFrame], 0, nullptr);
     }
 
     void Material::SetTexture(Ref<Texture> texture) {
@@ -284,16 +337,18 @@ namespace mc
             .imageView = texture->imageView,
             .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         };
-        VkWriteDescriptorSet descriptorWrite = {
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet = m_descriptorSet,
-            .dstBinding = 1,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .pImageInfo = &imageInfo,
-        };
+        for(VkDescriptorSet descriptorSet : m_descriptorSets) {
+            VkWriteDescriptorSet descriptorWrite = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = descriptorSet,
+                .dstBinding = 1,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &imageInfo,
+            };
 
-        vkUpdateDescriptorSets(state.device, 1, &descriptorWrite, 0, nullptr);
+            vkUpdateDescriptorSets(state.device, 1, &descriptorWrite, 0, nullptr);
+        }
     }
 }
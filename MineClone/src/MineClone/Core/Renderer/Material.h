@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <mutex>
 #include <vulkan/vulkan.h>
 
 #include "RendererTypes.h"
@@ -11,8 +12,17 @@ namespace mc
 
     class Material : public std::enable_shared_from_this<Material>
     {
+    public:
+        struct CreateInfo
+        {
+            std::string name;
+            const VertexDescription& vertexDescription;
+        };
+
     public:
         static Ref<Material> Create(const std::string& name, const VertexDescription& vertexDescription);
+        // Creates independent materials in parallel on the JobSystem, returned in the order of createInfos
+        static std::vector<Ref<Material>> Create(std::span<const CreateInfo> createInfos);
 
     public:
         Material(const Material&) = delete;
@@ -22,7 +32,7 @@ namespace mc
         Material& operator=(Material&&) noexcept = default;
 
     private:
-        Material(VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet descriptorSet, VkPipeline pipeline, VkPipelineLayout pipelineLayout);
+        Material(VkDescriptorSetLayout descriptorSetLayout, std::vector<VkDescriptorSet> descriptorSets, VkPipeline pipeline, VkPipelineLayout pipelineLayout);
 
     public:
         ~Material();
@@ -34,11 +44,14 @@ namespace mc
 
     private:
         VkDescriptorSetLayout m_descriptorSetLayout;
-        VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+        // One per frame in flight, each pointing at that frame's uniform and draw data buffers
+        std::vector<VkDescriptorSet> m_descriptorSets;
 
         VkPipeline m_pipeline = VK_NULL_HANDLE;
         VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
 
+        // Allocating from the shared descriptor pool has to be externally synchronized
+        inline static std::mutex s_descriptorPoolMutex;
 
         friend class RendererAPI;
     };
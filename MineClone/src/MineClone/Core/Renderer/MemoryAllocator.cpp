@@ -0,0 +1,153 @@
+﻿#include "mcpch.h"
+#include "MemoryAllocator.h"
+
+#include "RendererAPI.h"
+#include "VulkanTypes.h"
+#include "VulkanUtils.h"
+
+namespace mc
+{
+    MemoryBlock::MemoryBlock(VkDeviceMemory memory, u32 memoryType, u64 size, void* mappedMemory, bool dedicated)
+        : m_memory(memory), m_memoryType(memoryType), m_mappedMemory(mappedMemory), m_dedicated(dedicated), m_freeList(size) {}
+
+    void MemoryAllocator::Init() {
+        vkGetPhysicalDeviceMemoryProperties(RendererAPI::GetState().physicalDevice, &s_memoryProperties);
+    }
+
+    void MemoryAllocator::Deinit() {
+        std::lock_guard lock(s_mutex);
+
+        if(s_allocationCount > 0)
+            std::cout << std::format("MemoryAllocator: {} allocations still alive at shutdown\n", s_allocationCount);
+
+        for(auto& blocks : s_blocks) {
+            for(Scope<MemoryBlock>& block : blocks)
+                DestroyBlock(block.get());
+            blocks.clear();
+        }
+        s_allocationCount = 0;
+    }
+
+    MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties) {
+        u32 memoryType = details::VulkanUtils::FindMemoryType(requirements.memoryTypeBits, properties);
+        u64 heapSize = s_memoryProperties.memoryHeaps[s_memoryProperties.memoryTypes[memoryType].heapIndex].size;
+
+        // Small heaps (e.g. the 256 MiB host visible device local one) get smaller blocks
+        u64 blockSize = std::min(DEFAULT_BLOCK_SIZE, std::bit_floor(heapSize / 8));
+
+        std::lock_guard lock(s_mutex);
+        std::vector<Scope<MemoryBlock>>& blocks = s_blocks[memoryType];
+
+        MemoryBlock* block = nullptr;
+        u64 offset = 0;
+
+        if(requirements.size > blockSize / 2) {
+            block = CreateBlock(memoryType, requirements.size, true);
+            block->TryAllocate(requirements.size, 1, offset);
+        }
+        else {
+            for(Scope<MemoryBlock>& candidate : blocks)
+                if(!candidate->IsDedicated() && candidate->TryAllocate(requirements.size, requirements.alignment, offset)) {
+                    block = candidate.get();
+                    break;
+                }
+
+            if(!block) {
+                block = CreateBlock(memoryType, blockSize, false);
+                block->TryAllocate(requirements.size, requirements.alignment, offset);
+            }
+        }
+
+        s_allocationCount++;
+
+        return {
+            .memory = block->GetMemory(),
+            .offset = offset,
+            .size = requirements.size,
+            .mappedMemory = block->GetMappedMemory() ? (byte*)block->GetMappedMemory() + offset : nullptr,
+            .block = block,
+        };
+    }
+
+    void MemoryAllocator::Free(const MemoryAllocation& allocation) {
+        if(!allocation.IsValid())
+            return;
+
+        std::lock_guard lock(s_mutex);
+        MemoryBlock* block = allocation.block;
+
+        block->Release(allocation.offset, allocation.size);
+        s_allocationCount--;
+
+        if(!block->IsEmpty())
+            return;
+
+        // Keep one empty shared block per memory type around so a single buffer being recreated does not thrash
+        std::vector<Scope<MemoryBlock>>& blocks = s_blocks[block->GetMemoryType()];
+        bool keep = !block->IsDedicated() && std::ranges::count_if(blocks, [](const Scope<MemoryBlock>& other) {
+            return !other->IsDedicated();
+        }) == 1;
+
+        if(keep)
+            return;
+
+        DestroyBlock(block);
+        std::erase_if(blocks, [block](const Scope<MemoryBlock>& other) { return other.get() == block; });
+    }
+
+    MemoryStats MemoryAllocator::GetStats() {
+        std::lock_guard lock(s_mutex);
+
+        MemoryStats stats;
+        stats.allocationCount = s_allocationCount;
+
+        for(const auto& blocks : s_blocks)
+            for(const Scope<MemoryBlock>& block : blocks) {
+                stats.reservedBytes += block->GetSize();
+                stats.usedBytes += block->GetUsedBytes();
+
+                if(block->IsDedicated()) {
+                    stats.dedicatedCount++;
+                    continue;
+                }
+
+                stats.blockCount++;
+                for(auto [offset, size] : block->GetFreeRanges()) {
+                    stats.freeBytes += size;
+                    stats.freeRangeCount++;
+                    stats.largestFreeRange = std::max(stats.largestFreeRange, size);
+                }
+            }
+
+        return stats;
+    }
+
+    MemoryBlock* MemoryAllocator::CreateBlock(u32 memoryType, u64 size, bool dedicated) {
+        auto& state = RendererAPI::GetState();
+
+        VkMemoryAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = size,
+            .memoryTypeIndex = memoryType,
+        };
+
+        VkDeviceMemory memory;
+        if(vkAllocateMemory(state.device, &allocInfo, state.allocator, &memory) != VK_SUCCESS)
+            throw std::runtime_error("failed to allocate device memory block!");
+
+        void* mappedMemory = nullptr;
+        if(s_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+            vkMapMemory(state.device, memory, 0, VK_WHOLE_SIZE, 0, &mappedMemory);
+
+        return s_blocks[memoryType].emplace_back(CreateScope<MemoryBlock>(memory, memoryType, size, mappedMemory, dedicated)).get();
+    }
+
+    void MemoryAllocator::DestroyBlock(MemoryBlock* block) {
+        auto& state = RendererAPI::GetState();
+
+        if(block->GetMappedMemory())
+            vkUnmapMemory(state.device, block->GetMemory());
+
+        vkFreeMemory(state.device, block->GetMemory(), state.allocator);
+    }
+}
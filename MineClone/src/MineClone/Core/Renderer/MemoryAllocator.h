@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include <mutex>
+#include <vulkan/vulkan.h>
+
+#include "FreeList.h"
+
+namespace mc
+{
+    // One vkAllocateMemory worth of device memory, free space is kept in a FreeList
+    class MemoryBlock
+    {
+    public:
+        MemoryBlock(VkDeviceMemory memory, u32 memoryType, u64 size, void* mappedMemory, bool dedicated);
+
+        // First fit, returns false when no free range can hold size bytes at the given alignment
+        bool TryAllocate(u64 size, u64 alignment, u64& outOffset) { return m_freeList.TryAllocate(size, alignment, outOffset); }
+        void Release(u64 offset, u64 size) { m_freeList.Release(offset, size); }
+
+    public:
+        bool IsEmpty() const { return m_freeList.IsEmpty(); }
+        bool IsDedicated() const { return m_dedicated; }
+
+        VkDeviceMemory GetMemory() const { return m_memory; }
+        u32 GetMemoryType() const { return m_memoryType; }
+        u64 GetSize() const { return m_freeList.GetSize(); }
+        u64 GetUsedBytes() const { return m_freeList.GetUsedSize(); }
+        void* GetMappedMemory() const { return m_mappedMemory; }
+
+        const std::map<u64, u64>& GetFreeRanges() const { return m_freeList.GetFreeRanges(); }
+
+    private:
+        VkDeviceMemory m_memory;
+        u32 m_memoryType;
+        void* m_mappedMemory;
+        bool m_dedicated;
+
+        FreeList m_freeList;
+    };
+
+    // Slice of a device memory block handed out by MemoryAllocator
+    struct MemoryAllocation
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        u64 offset = 0;
+        u64 size = 0;
+
+        // Points at offset inside the block, host visible blocks stay mapped for their whole lifetime
+        void* mappedMemory = nullptr;
+
+        MemoryBlock* block = nullptr;
+
+        bool IsValid() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct MemoryStats
+    {
+        u64 blockCount = 0;
+        u64 dedicatedCount = 0;
+        u64 allocationCount = 0;
+
+        // Device memory taken from the driver vs. handed out to buffers
+        u64 reservedBytes = 0;
+        u64 usedBytes = 0;
+
+        u64 freeBytes = 0;
+        u64 freeRangeCount = 0;
+        u64 largestFreeRange = 0;
+
+        // 0 when the free space of every block is one contiguous range, approaches 1 as it splinters
+        f32 GetFragmentation() const { return freeBytes == 0 ? 0.f : 1.f - (f32)largestFreeRange / (f32)freeBytes; }
+    };
+
+    // Carves buffers out of large VkDeviceMemory blocks instead of calling vkAllocateMemory per buffer.
+    // Every memory type owns a list of blocks, each tracking its free space in an offset ordered free list
+    // that coalesces neighbouring ranges on free. Requests larger than half a block get a dedicated allocation.
+    class MemoryAllocator
+    {
+    public:
+        static void Init();
+        static void Deinit();
+
+        static MemoryAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties);
+
+        // The GPU must be done with the memory, defer through the DeletionQueue
+        static void Free(const MemoryAllocation& allocation);
+
+        static MemoryStats GetStats();
+
+    private:
+        static MemoryBlock* CreateBlock(u32 memoryType, u64 size, bool dedicated);
+        static void DestroyBlock(MemoryBlock* block);
+
+    private:
+        static constexpr u64 DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+        inline static VkPhysicalDeviceMemoryProperties s_memoryProperties{};
+        inline static std::array<std::vector<Scope<MemoryBlock>>, VK_MAX_MEMORY_TYPES> s_blocks;
+        inline static u64 s_allocationCount = 0;
+
+        inline static std::mutex s_mutex;
+    };
+}
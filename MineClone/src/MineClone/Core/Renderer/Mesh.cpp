@@ -10,42 +10,33 @@ namespace mc
     }
 
     void Mesh::Render(const Mat4& transform) const {
-        if(m_vertexBuffer && m_indexBuffer)
+        if(m_quads) {
+            if(m_vertexBuffer && m_vertexCount > 0)
+                RendererAPI::DrawQuads(transform, m_vertexBuffer, m_vertexCount / 4);
+        }
+        else if(m_vertexBuffer && m_indexBuffer)
             RendererAPI::Draw(transform, m_vertexBuffer, m_indexBuffer, m_indicesCount);
     }
 
-    void Mesh::SetIndices(std::span<const u32> indices) {
-        u32 newCount = (u32)indices.size();
-
-        if(m_indexBufferCap < newCount) {
-            // Create/recreate buffer
-            m_indexBuffer = Buffer::CreateIndexBuffer(indices);
-            m_indexBufferCap = newCount;
-        }
-        else if(newCount > 0) {
-            // Update Data
-            u64 size = newCount * sizeof(u32);
-            auto stageBuffer = Buffer::CreateStageBuffer(size, indices.data());
-
-            RendererAPI::CopyBuffer(stageBuffer, m_indexBuffer, size);
-        }
+    void Mesh::RenderChunkQuads(float3 origin, u32 firstQuad, u32 quadCount) const {
+        if(m_quads && m_vertexBuffer && quadCount > 0)
+            RendererAPI::DrawChunkQuads(origin, m_vertexBuffer, quadCount, firstQuad);
+    }
 
-        m_indicesCount = newCount;
+    void Mesh::SetIndices(std::span<const u32> indices) {
+        m_quads = false;
+        
+        m_indexBuffer = indices.empty() ? nullptr : Buffer::CreateIndexBuffer(indices);
+        m_indicesCount = (u32)indices.size();
     }
 
     void Mesh::Dispose() {
-        if(m_indexBuffer)
-            m_indexBuffer->Delete();
-
-        if(m_vertexBuffer)
-            m_vertexBuffer->Delete();
-
+        // Buffers may still be referenced by pending uploads, the last reference deletes them
         m_indexBuffer = nullptr;
         m_vertexBuffer = nullptr;
         
-        m_indexBufferCap = 0;
-        m_vertexBufferCap = 0;
         m_indicesCount = 0;
         m_vertexCount = 0;
+        m_quads = false;
     }
 }
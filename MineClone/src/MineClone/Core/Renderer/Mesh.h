@@ -18,22 +18,33 @@ namespace mc
     public:
         
         void Render(const Mat4& transform) const;
+        // Draws quadCount quads starting at firstQuad of a quad mesh, with a material using ChunkPushConstants
+        void RenderChunkQuads(float3 origin, u32 firstQuad, u32 quadCount) const;
 
         void SetIndices(std::span<const u32> indices);
 
         template <typename T>
         void SetVertices(std::span<T> vertices);
 
+        // Quad list of 4 vertices per quad drawn with the shared quad index buffer, replaces any own indices
+        template <typename T>
+        void SetQuads(std::span<T> vertices);
+
         void Dispose();
+
+    public:
+        u32 GetVertexCount() const { return m_vertexCount; }
+        u32 GetIndexCount() const { return m_indicesCount; }
         
     private:
+        // Every upload goes into a fresh buffer, replaced buffers are retired once the frames drawing them completed
         Ref<Buffer> m_vertexBuffer;
         Ref<Buffer> m_indexBuffer;
-        u64 m_vertexBufferCap = 0;
-        u64 m_indexBufferCap = 0;
 
         u32 m_vertexCount = 0;
         u32 m_indicesCount = 0;
+
+        bool m_quads = false;
     };
 }
 
@@ -6,21 +6,18 @@ namespace mc
 {
     template <typename T>
     void Mesh::SetVertices(std::span<T> vertices) {
-        u32 newCount = (u32)vertices.size();
-        
-        if(m_vertexBufferCap < newCount) {
-            // Create/recreate buffer
-            m_vertexBuffer = Buffer::CreateVertexBuffer<T>(vertices);
-            m_vertexBufferCap = newCount;
-        }
-        else if(newCount > 0) {
-            // Update Data
-            u64 size = newCount * sizeof(T);
-            
-            auto stageBuffer = Buffer::CreateStageBuffer(size, vertices.data());
-            RendererAPI::CopyBuffer(stageBuffer, m_vertexBuffer, size);
-        }
+        // Dropping the old buffer defers its deletion, frames in flight keep drawing it
+        m_vertexBuffer = vertices.empty() ? nullptr : Buffer::CreateVertexBuffer<T>(vertices);
+        m_vertexCount = (u32)vertices.size();
+    }
+
+    template <typename T>
+    void Mesh::SetQuads(std::span<T> vertices) {
+        m_indexBuffer = nullptr;
+        m_indicesCount = 0;
 
-        m_vertexCount = newCount;
+        RendererAPI::ReserveQuadIndices((u32)vertices.size() / 4);
+        SetVertices(vertices);
+        m_quads = true;
     }
 }
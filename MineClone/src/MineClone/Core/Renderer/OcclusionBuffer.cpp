@@ -0,0 +1,211 @@
+﻿#include "mcpch.h"
+#include "OcclusionBuffer.h"
+
+#include "MineClone/Core/Threading/JobSystem.h"
+
+namespace mc
+{
+    // Corner i has x from bit 0, y from bit 1 and z from bit 2, quads wind counter clockwise seen from outside
+    static constexpr std::array<std::array<u32, 4>, 6> BOX_FACES = {{
+        {2, 6, 7, 3}, // +y
+        {0, 1, 5, 4}, // -y
+        {4, 5, 7, 6}, // +z
+        {0, 2, 3, 1}, // -z
+        {1, 3, 7, 5}, // +x
+        {0, 4, 6, 2}, // -x
+    }};
+
+    OcclusionBuffer::OcclusionBuffer() {
+        for(u32 level = 0; level < LEVEL_COUNT; level++) {
+            uint2 size = GetLevelSize(level);
+            m_levels[level].assign((u64)size.x * size.y, 1.f);
+        }
+    }
+
+    void OcclusionBuffer::Begin(const Mat4& viewProjection) {
+        m_viewProjection = viewProjection;
+        m_triangles.clear();
+        m_occluderCount = 0;
+        // Every level, a frame without occluders never rebuilds the pyramid
+        for(std::vector<f32>& level : m_levels)
+            std::ranges::fill(level, 1.f);
+    }
+
+    void OcclusionBuffer::AddOccluder(float3 min, float3 max) {
+        std::array<float3, 8> corners;
+        for(u32 i = 0; i < 8; i++) {
+            float3 position = {i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z};
+            if(!Project(position, corners[i]))
+                return;
+        }
+
+        m_occluderCount++;
+        for(const std::array<u32, 4>& face : BOX_FACES)
+            for(std::array<u32, 3> indices : {std::array{face[0], face[1], face[2]}, std::array{face[0], face[2], face[3]}}) {
+                Triangle triangle{{corners[indices[0]], corners[indices[1]], corners[indices[2]]}};
+
+                // Rows run top to bottom, so front faces turn clockwise on screen. Back faces of a solid box
+                // are always behind its front faces and edge on faces cover nothing.
+                if(GetDoubleArea(triangle) >= 0)
+                    continue;
+
+                f32 minY = std::min({triangle.vertices[0].y, triangle.vertices[1].y, triangle.vertices[2].y});
+                f32 maxY = std::max({triangle.vertices[0].y, triangle.vertices[1].y, triangle.vertices[2].y});
+                triangle.minY = std::max((i32)std::floor(minY), 0);
+                triangle.maxY = std::min((i32)std::ceil(maxY), (i32)HEIGHT - 1);
+
+                m_triangles.push_back(triangle);
+            }
+    }
+
+    void OcclusionBuffer::Rasterize(bool parallel) {
+        constexpr u32 BAND_COUNT = HEIGHT / BAND_HEIGHT;
+
+        if(parallel)
+            JobSystem::ParallelFor(BAND_COUNT, [this](u32 band) { RasterizeBand(band); });
+        else
+            for(u32 band = 0; band < BAND_COUNT; band++)
+                RasterizeBand(band);
+
+        BuildPyramid();
+    }
+
+    bool OcclusionBuffer::IsVisible(float3 min, float3 max) const {
+        float3 screenMin{std::numeric_limits<f32>::max()};
+        float3 screenMax{std::numeric_limits<f32>::lowest()};
+
+        for(u32 i = 0; i < 8; i++) {
+            float3 screen;
+            if(!Project({i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z}, screen))
+                return true;
+
+            screenMin = glm::min(screenMin, screen);
+            screenMax = glm::max(screenMax, screen);
+        }
+
+        i32 minX = std::max((i32)std::floor(screenMin.x), 0);
+        i32 minY = std::max((i32)std::floor(screenMin.y), 0);
+        i32 maxX = std::min((i32)std::floor(screenMax.x), (i32)WIDTH - 1);
+        i32 maxY = std::min((i32)std::floor(screenMax.y), (i32)HEIGHT - 1);
+
+        // Off screen, that is for the frustum test to decide
+        if(minX > maxX || minY > maxY)
+            return true;
+
+        // Coarsest level at which the rectangle still spans at most 2x2 texels
+        u32 level = 0;
+        while(level + 1 < LEVEL_COUNT && ((maxX >> level) - (minX >> level) > 1 || (maxY >> level) - (minY >> level) > 1))
+            level++;
+
+        const std::vector<f32>& depths = m_levels[level];
+        u32 width = GetLevelSize(level).x;
+
+        for(i32 y = minY >> level; y <= maxY >> level; y++)
+            for(i32 x = minX >> level; x <= maxX >> level; x++)
+                if(screenMin.z <= depths[(u64)y * width + x] + DEPTH_BIAS)
+                    return true;
+
+        return false;
+    }
+
+    void OcclusionBuffer::WriteImage(const std::filesystem::path& path, u32 level) const {
+        uint2 size = GetLevelSize(level);
+
+        std::ofstream file(path, std::ios::binary);
+        if(!file)
+            throw std::runtime_error(std::format("failed to open {} for writing!", path.string()));
+
+        file << std::format("P5\n{} {}\n255\n", size.x, size.y);
+        for(f32 depth : m_levels[level])
+            file.put((char)(u8)std::lround(std::clamp(depth, 0.f, 1.f) * 255.f));
+    }
+
+    void OcclusionBuffer::RasterizeBand(u32 band) {
+        i32 bandMinY = (i32)(band * BAND_HEIGHT);
+        i32 bandMaxY = bandMinY + (i32)BAND_HEIGHT - 1;
+
+        for(const Triangle& triangle : m_triangles)
+            if(triangle.maxY >= bandMinY && triangle.minY <= bandMaxY)
+                RasterizeTriangle(triangle, bandMinY, bandMaxY);
+    }
+
+    void OcclusionBuffer::RasterizeTriangle(const Triangle& triangle, i32 bandMinY, i32 bandMaxY) {
+        float3 v0 = triangle.vertices[0];
+        float3 v1 = triangle.vertices[1];
+        float3 v2 = triangle.vertices[2];
+
+        // Swapping two vertices turns the clockwise front faces around so all edge functions are positive inside
+        std::swap(v1, v2);
+        f32 area = -GetDoubleArea(triangle);
+
+        i32 minX = std::max((i32)std::floor(std::min({v0.x, v1.x, v2.x})), 0);
+        i32 maxX = std::min((i32)std::ceil(std::max({v0.x, v1.x, v2.x})), (i32)WIDTH - 1);
+        i32 minY = std::max(triangle.minY, bandMinY);
+        i32 maxY = std::min(triangle.maxY, bandMaxY);
+
+        std::vector<f32>& depths = m_levels[0];
+        f32 inverseArea = 1.f / area;
+
+        // Edge functions and depth are evaluated at the first pixel center and stepped per pixel from there
+        f32 stepX0 = v1.y - v2.y, stepY0 = v2.x - v1.x;
+        f32 stepX1 = v2.y - v0.y, stepY1 = v0.x - v2.x;
+        f32 stepX2 = v0.y - v1.y, stepY2 = v1.x - v0.x;
+
+        f32 px = (f32)minX + 0.5f;
+        f32 py = (f32)minY + 0.5f;
+        f32 row0 = stepY0 * (py - v1.y) + stepX0 * (px - v1.x);
+        f32 row1 = stepY1 * (py - v2.y) + stepX1 * (px - v2.x);
+        f32 row2 = stepY2 * (py - v0.y) + stepX2 * (px - v0.x);
+
+        for(i32 y = minY; y <= maxY; y++, row0 += stepY0, row1 += stepY1, row2 += stepY2) {
+            f32 w0 = row0, w1 = row1, w2 = row2;
+            f32* stored = &depths[(u64)y * WIDTH + minX];
+
+            for(i32 x = minX; x <= maxX; x++, w0 += stepX0, w1 += stepX1, w2 += stepX2, stored++) {
+                if(w0 < 0 || w1 < 0 || w2 < 0)
+                    continue;
+
+                f32 depth = (w0 * v0.z + w1 * v1.z + w2 * v2.z) * inverseArea;
+                *stored = std::min(*stored, depth);
+            }
+        }
+    }
+
+    void OcclusionBuffer::BuildPyramid() {
+        for(u32 level = 1; level < LEVEL_COUNT; level++) {
+            const std::vector<f32>& source = m_levels[level - 1];
+            std::vector<f32>& target = m_levels[level];
+            uint2 sourceSize = GetLevelSize(level - 1);
+            uint2 size = GetLevelSize(level);
+
+            // Farthest depth of the 2x2 texels below, so a texel never claims more occlusion than its area has
+            for(u32 y = 0; y < size.y; y++)
+                for(u32 x = 0; x < size.x; x++) {
+                    u64 index = (u64)(y * 2) * sourceSize.x + x * 2;
+                    target[(u64)y * size.x + x] = std::max({source[index], source[index + 1],
+                                                            source[index + sourceSize.x], source[index + sourceSize.x + 1]});
+                }
+        }
+    }
+
+    f32 OcclusionBuffer::GetDoubleArea(const Triangle& triangle) {
+        const auto& [v0, v1, v2] = triangle.vertices;
+        return (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    }
+
+    bool OcclusionBuffer::Project(float3 position, float3& outScreen) const {
+        float4 clip = m_viewProjection * float4(position, 1.f);
+        if(clip.w < MIN_W)
+            return false;
+
+        float3 ndc = float3(clip) / clip.w;
+
+        // Rows go top to bottom, depth is mapped from [-1, 1] to [0, 1]
+        outScreen = {
+            (ndc.x * 0.5f + 0.5f) * (f32)WIDTH,
+            (0.5f - ndc.y * 0.5f) * (f32)HEIGHT,
+            std::clamp(ndc.z * 0.5f + 0.5f, 0.f, 1.f),
+        };
+        return true;
+    }
+}
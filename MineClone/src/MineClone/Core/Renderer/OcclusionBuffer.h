@@ -0,0 +1,72 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Low resolution software depth buffer with a max depth pyramid (hi-Z) for occlusion culling on the CPU.
+    // Occluder boxes are rasterized in horizontal bands, one band per job, every pixel is only ever written
+    // by its band in occluder order, so the result does not depend on thread count or scheduling.
+    class OcclusionBuffer
+    {
+    public:
+        static constexpr u32 WIDTH = 256;
+        static constexpr u32 HEIGHT = 128;
+        static constexpr u32 BAND_HEIGHT = 16;
+        static constexpr u32 LEVEL_COUNT = 5;
+
+    public:
+        OcclusionBuffer();
+
+        // Clears all levels to the far plane and drops all occluders
+        void Begin(const Mat4& viewProjection);
+
+        // Box must be fully solid. Boxes crossing the near plane are skipped.
+        void AddOccluder(float3 min, float3 max);
+
+        // Rasterizes all occluders and builds the depth pyramid, on the JobSystem when parallel
+        void Rasterize(bool parallel = true);
+
+        // False only when the box is certainly hidden behind rasterized occluders
+        bool IsVisible(float3 min, float3 max) const;
+
+    public:
+        u32 GetOccluderCount() const { return m_occluderCount; }
+        u32 GetTriangleCount() const { return (u32)m_triangles.size(); }
+
+        // Level 0 is the full resolution buffer, every next level halves both dimensions
+        std::span<const f32> GetLevel(u32 level) const { return m_levels[level]; }
+        static uint2 GetLevelSize(u32 level) { return {WIDTH >> level, HEIGHT >> level}; }
+
+        // Binary PGM, near is black and the far plane white
+        void WriteImage(const std::filesystem::path& path, u32 level = 0) const;
+
+    private:
+        struct Triangle
+        {
+            // Screen space xy in pixels, z in [0, 1] depth
+            std::array<float3, 3> vertices;
+            i32 minY;
+            i32 maxY;
+        };
+
+        void RasterizeBand(u32 band);
+        void RasterizeTriangle(const Triangle& triangle, i32 bandMinY, i32 bandMaxY);
+        void BuildPyramid();
+
+        // Twice the signed screen space area, negative for clockwise triangles
+        static f32 GetDoubleArea(const Triangle& triangle);
+
+        // Returns false for points behind the near plane
+        bool Project(float3 position, float3& outScreen) const;
+
+    private:
+        // Points closer than this clip space w are treated as crossing the near plane
+        static constexpr f32 MIN_W = 0.1f;
+        // Tolerance against the depth interpolation error of rasterized occluders
+        static constexpr f32 DEPTH_BIAS = 1e-5f;
+
+        Mat4 m_viewProjection{1};
+        std::vector<Triangle> m_triangles;
+        u32 m_occluderCount = 0;
+        std::array<std::vector<f32>, LEVEL_COUNT> m_levels;
+    };
+}
@@ -0,0 +1,107 @@
+﻿#include "mcpch.h"
+#include "PngWriter.h"
+
+namespace mc
+{
+    static constexpr std::array<u32, 256> CRC_TABLE = [] {
+        std::array<u32, 256> table{};
+        for(u32 n = 0; n < 256; n++) {
+            u32 c = n;
+            for(u32 k = 0; k < 8; k++)
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        return table;
+    }();
+
+    void PngWriter::Write(const std::filesystem::path& path, u32 width, u32 height, std::span<const u8> pixels) {
+        if(pixels.size() < (u64)width * height * 4)
+            throw std::runtime_error("PNG pixel data smaller than the image!");
+
+        std::ofstream file(path, std::ios::binary);
+        if(!file)
+            throw std::runtime_error(std::format("failed to open {} for writing!", path.string()));
+
+        constexpr std::array<u8, 8> SIGNATURE = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write((const char*)SIGNATURE.data(), SIGNATURE.size());
+
+        std::vector<u8> header;
+        AppendBigEndian(header, width);
+        AppendBigEndian(header, height);
+        // 8 bit depth, truecolor, deflate, adaptive filtering, no interlace
+        header.insert(header.end(), {8, 2, 0, 0, 0});
+        WriteChunk(file, "IHDR", header);
+
+        // Every row starts with its filter type, 0 leaves the bytes as they are
+        u64 rowSize = 1 + (u64)width * 3;
+        std::vector<u8> rows;
+        rows.reserve(rowSize * height);
+        for(u32 y = 0; y < height; y++) {
+            rows.push_back(0);
+            const u8* texel = pixels.data() + (u64)y * width * 4;
+            for(u32 x = 0; x < width; x++, texel += 4)
+                rows.insert(rows.end(), {texel[0], texel[1], texel[2]});
+        }
+
+        // zlib stream of stored deflate blocks, no compression
+        std::vector<u8> data = {0x78, 0x01};
+        data.reserve(rows.size() + rows.size() / MAX_STORED_BLOCK_SIZE * 5 + 16);
+        for(u64 offset = 0; offset < rows.size() || offset == 0; offset += MAX_STORED_BLOCK_SIZE) {
+            u16 size = (u16)std::min<u64>(MAX_STORED_BLOCK_SIZE, rows.size() - offset);
+            bool last = offset + size >= rows.size();
+
+            data.insert(data.end(), {(u8)last, (u8)size, (u8)(size >> 8), (u8)~size, (u8)(~size >> 8)});
+            data.insert(data.end(), rows.begin() + (i64)offset, rows.begin() + (i64)(offset + size));
+        }
+        AppendBigEndian(data, GetAdler32(rows));
+        WriteChunk(file, "IDAT", data);
+
+        WriteChunk(file, "IEND", {});
+
+        if(!file)
+            throw std::runtime_error(std::format("failed to write {}!", path.string()));
+    }
+
+    void PngWriter::WriteChunk(std::ofstream& file, std::string_view type, std::span<const u8> data) {
+        std::vector<u8> length;
+        AppendBigEndian(length, (u32)data.size());
+        file.write((const char*)length.data(), (std::streamsize)length.size());
+
+        file.write(type.data(), (std::streamsize)type.size());
+        file.write((const char*)data.data(), (std::streamsize)data.size());
+
+        std::vector<u8> crc;
+        AppendBigEndian(crc, GetCrc(type, data));
+        file.write((const char*)crc.data(), (std::streamsize)crc.size());
+    }
+
+    void PngWriter::AppendBigEndian(std::vector<u8>& data, u32 value) {
+        data.insert(data.end(), {(u8)(value >> 24), (u8)(value >> 16), (u8)(value >> 8), (u8)value});
+    }
+
+    u32 PngWriter::GetCrc(std::string_view type, std::span<const u8> data) {
+        u32 crc = ~0u;
+        for(char c : type)
+            crc = CRC_TABLE[(crc ^ (u8)c) & 0xFF] ^ (crc >> 8);
+        for(u8 byte : data)
+            crc = CRC_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    u32 PngWriter::GetAdler32(std::span<const u8> data) {
+        constexpr u32 MOD = 65521;
+        // Sums stay below 2^32 for this many bytes before they have to be reduced
+        constexpr u64 MAX_RUN = 5552;
+
+        u32 a = 1, b = 0;
+        for(u64 offset = 0; offset < data.size(); offset += MAX_RUN) {
+            for(u8 byte : data.subspan(offset, std::min(MAX_RUN, data.size() - offset))) {
+                a += byte;
+                b += a;
+            }
+            a %= MOD;
+            b %= MOD;
+        }
+        return (b << 16) | a;
+    }
+}
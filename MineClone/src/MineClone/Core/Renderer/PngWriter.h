@@ -0,0 +1,24 @@
+﻿#pragma once
+
+namespace mc
+{
+    // Minimal PNG encoder for frame captures, stb only ships the loader here.
+    // Writes 8 bit RGB with the image data in uncompressed deflate blocks, large but cheap to produce.
+    class PngWriter
+    {
+    public:
+        // pixels holds width * height tightly packed RGBA texels, top row first. Alpha is dropped.
+        static void Write(const std::filesystem::path& path, u32 width, u32 height, std::span<const u8> pixels);
+
+    private:
+        static void WriteChunk(std::ofstream& file, std::string_view type, std::span<const u8> data);
+        static void AppendBigEndian(std::vector<u8>& data, u32 value);
+
+        static u32 GetCrc(std::string_view type, std::span<const u8> data);
+        static u32 GetAdler32(std::span<const u8> data);
+
+    private:
+        // Largest payload of a stored deflate block
+        static constexpr u32 MAX_STORED_BLOCK_SIZE = 65535;
+    };
+}
@@ -3,7 +3,12 @@
 
 #include "VulkanTypes.h"
 #include "RendererTypes.h"
+#include "StagingRing.h"
+#include "GeometryArena.h"
+#include "DeletionQueue.h"
+#include "PngWriter.h"
 #include "MineClone/Application.h"
+#include "MineClone/Config.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -11,49 +16,98 @@
 #include <GLFW/glfw3.h>
 
 #include "VulkanUtils.h"
+#include "MineClone/Core/Profiling/Profiler.h"
+#include "MineClone/Core/Threading/JobSystem.h"
 
 namespace mc
 {
     static inline GlobalState g_state{};
 
+    // Secondary command buffer the calling thread records into during RendererAPI::RecordParallel
+    static thread_local VkCommandBuffer t_recordingCommandBuffer = VK_NULL_HANDLE;
+
     void RendererAPI::Init() {
         std::cout << "Renderer Init.\n";
         CreateInstance();
         SetupDebugMessenger();
         CreateSurface();
+        CreateDeviceObjects();
+    }
+
+    void RendererAPI::InitHeadless(u32 width, u32 height) {
+        std::cout << std::format("Renderer Init, headless {}x{}.\n", width, height);
+        g_state.headless = true;
+        g_state.swapchainExtent = {width, height};
+
+        CreateInstance();
+        SetupDebugMessenger();
+        CreateDeviceObjects();
+    }
 
+    void RendererAPI::CreateDeviceObjects() {
         PickPhysicalDevice();
         CreateLogicalDevice();
-        CreateSwapchain();
+        CreatePipelineCache();
+        MemoryAllocator::Init();
+        StagingRing::Init(Config::STAGING_BUFFER_SIZE_MB * 1024 * 1024);
+        GeometryArena::Init(Config::GEOMETRY_ARENA_SIZE_MB * 1024 * 1024);
+        if(g_state.headless)
+            CreateOffscreenImages();
+        else
+            CreateSwapchain();
         CreateImageViews();
         
         CreateDepthBuffer();
         CreateRenderPass();
 
         CreateUniformBuffers();
+        CreateIndirectBuffers();
         CreateDescriptorPool();
         
         CreateFramebuffers();
         CreateCommandPool();
         CreateCommandBuffers();
         CreateSyncObjects();
+        CreateQueryPools();
     }
 
     void RendererAPI::Deinit() {
         std::cout << "Renderer Deinit.\n";
         vkDeviceWaitIdle(g_state.device);
 
-
+        for(FrameData& frame : g_state.frames)
+            WriteCapture(frame);
         
         CleanupSwapchain();
 
+        // Dropped before the explicit deletes below, a pending copy must never see a deleted buffer
+        g_state.pendingBufferCopies.clear();
+        g_state.pendingImageCopies.clear();
+
+        if(g_state.quadIndexBuffer) {
+            g_state.quadIndexBuffer->Delete();
+            g_state.quadIndexBuffer = nullptr;
+        }
+
+        // Deleters of every frame have to be queued before any of them run
+        StagingRing::Deinit();
+        GeometryArena::Deinit();
         for(FrameData& frame : g_state.frames) {
             frame.uboBuffer->Delete();
-            for(auto& fn : frame.afterSubmit)
-                fn();
-            frame.afterSubmit.clear();
+            frame.indirectBuffer->Delete();
+            frame.drawDataBuffer->Delete();
+            if(frame.captureBuffer)
+                frame.captureBuffer->Delete();
+            frame.uploadBuffers.clear();
         }
 
+        DeletionQueue::FlushAll();
+
+        MemoryAllocator::Deinit();
+
+        SavePipelineCache();
+        vkDestroyPipelineCache(g_state.device, g_state.pipelineCache, g_state.allocator);
+
         vkDestroyDescriptorPool(g_state.device, g_state.descriptorPool, g_state.allocator);
 
         vkDestroyRenderPass(g_state.device, g_state.renderPass, g_state.allocator);
@@ -66,8 +120,12 @@ namespace mc
             vkDestroySemaphore(g_state.device, frame.presentSemaphore, g_state.allocator);
             vkDestroySemaphore(g_state.device, frame.renderSemaphore, g_state.allocator);
             vkDestroyFence(g_state.device, frame.renderFence, g_state.allocator);
+            vkDestroyQueryPool(g_state.device, frame.timestampPool, g_state.allocator);
 
             vkDestroyCommandPool(g_state.device, frame.commandPool, g_state.allocator);
+            for(SecondaryCommandPool& pool : frame.secondaryPools)
+                vkDestroyCommandPool(g_state.device, pool.commandPool, g_state.allocator);
+            frame.secondaryPools.clear();
         }
 
         vkDestroyDevice(g_state.device, g_state.allocator);
@@ -79,7 +137,8 @@ namespace mc
                 func(g_state.instance, g_state.debugMessenger, g_state.allocator);
         }
 
-        vkDestroySurfaceKHR(g_state.instance, g_state.surface, g_state.allocator);
+        if(!g_state.headless)
+            vkDestroySurfaceKHR(g_state.instance, g_state.surface, g_state.allocator);
         vkDestroyInstance(g_state.instance, g_state.allocator);
     }
 
@@ -89,24 +148,42 @@ namespace mc
 
 
     void RendererAPI::BeginFrame(float deltaTime, const Camera& camera) {
+        MC_PROFILE_SCOPE("RendererAPI::BeginFrame");
         FrameData& frame = g_state.GetCurrentFrame();
         vkWaitForFences(g_state.device, 1, &frame.renderFence, true, std::numeric_limits<u64>::max());
         vkResetFences(g_state.device, 1, &frame.renderFence);
+        StagingRing::ReclaimFrame(g_state.currentFrame);
+        frame.uploadBuffers.clear();
+        frame.indirectDrawCount = 0;
 
-        VkResult result = vkAcquireNextImageKHR(g_state.device, g_state.swapchain, UINT64_MAX, frame.renderSemaphore,
-                                                VK_NULL_HANDLE, &frame.currentImageIndex);
-
-        if(result == VK_ERROR_OUT_OF_DATE_KHR) {
-            RecreateSwapchain();
-            return;
+        for(SecondaryCommandPool& pool : frame.secondaryPools) {
+            vkResetCommandPool(g_state.device, pool.commandPool, 0);
+            pool.usedCount = 0;
         }
 
-        if(result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
-            throw std::runtime_error("failed to acquire swap chain image!");
+        DeletionQueue::FlushFrame(g_state.currentFrame);
+
+        ReadTimestamps(frame);
+        WriteCapture(frame);
+
+        if(g_state.headless)
+            frame.currentImageIndex = g_state.currentFrame;
+        else {
+            VkResult result = vkAcquireNextImageKHR(g_state.device, g_state.swapchain, UINT64_MAX, frame.renderSemaphore,
+                                                    VK_NULL_HANDLE, &frame.currentImageIndex);
+
+            if(result == VK_ERROR_OUT_OF_DATE_KHR) {
+                RecreateSwapchain();
+                return;
+            }
+
+            if(result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+                throw std::runtime_error("failed to acquire swap chain image!");
+        }
 
         static float time = 0;
         time += deltaTime;
-        frame.ubo = {{deltaTime, time, 0, 0}, camera.GetProjection(), camera.GetView()};
+        frame.ubo = {{deltaTime, time, 0, 0}, camera.GetProjection(), camera.GetView(), camera.GetProjection() * camera.GetView()};
         memcpy(frame.uboBuffer->mappedMemory, &frame.ubo, sizeof(frame.ubo));
 
         vkResetCommandBuffer(frame.commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
@@ -124,10 +201,24 @@ namespace mc
         if(vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS)
             throw std::runtime_error("failed to begin recording command buffer!");
 
-        for(auto& fn : g_state.nextFrameSubmits)
-            fn(frame.commandBuffer);
-        g_state.nextFrameSubmits.clear();
+        if(frame.timestampPool) {
+            vkCmdResetQueryPool(frame.commandBuffer, frame.timestampPool, 0, FrameData::TIMESTAMP_COUNT);
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampPool, 0);
+        }
+
+        DeletionQueue::BeginFrame();
+
+        RecordUploads(frame);
+        StagingRing::MarkFrame(g_state.currentFrame);
+
+        if(frame.timestampPool)
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, 1);
         
+        BeginRenderPass(frame);
+        BeginInlineCommandBuffer(frame);
+    }
+
+    void RendererAPI::BeginRenderPass(FrameData& frame) {
         std::array clearColor = {
             VkClearValue{.color = {{0.46f, 0.46f, 0.46f, 1.0f}}},
             VkClearValue{.depthStencil = {1.f, 0}},
@@ -144,8 +235,48 @@ namespace mc
             .clearValueCount = static_cast<u32>(clearColor.size()),
             .pClearValues = clearColor.data(),
         };
-        vkCmdBeginRenderPass(frame.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        // Everything drawn in the pass is recorded into secondary command buffers, executed in order by EndFrame
+        vkCmdBeginRenderPass(frame.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    }
 
+    void RendererAPI::BeginSecondaryCommandBuffer(FrameData& frame, VkCommandBuffer commandBuffer) {
+        VkCommandBufferInheritanceInfo inheritanceInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .renderPass = g_state.renderPass,
+            .subpass = 0,
+            .framebuffer = g_state.swapchainFramebuffers[frame.currentImageIndex],
+        };
+
+        VkCommandBufferBeginInfo beginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = &inheritanceInfo,
+        };
+
+        if(vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+            throw std::runtime_error("failed to begin recording secondary command buffer!");
+
+        // Secondary command buffers inherit no dynamic state
+        SetViewportAndScissor(commandBuffer);
+    }
+
+    void RendererAPI::BeginInlineCommandBuffer(FrameData& frame) {
+        frame.inlineCommandBuffer = AcquireSecondaryCommandBuffer(frame, 0);
+        BeginSecondaryCommandBuffer(frame, frame.inlineCommandBuffer);
+        frame.passCommandBuffers.push_back(frame.inlineCommandBuffer);
+    }
+
+    void RendererAPI::EndInlineCommandBuffer(FrameData& frame) {
+        if(vkEndCommandBuffer(frame.inlineCommandBuffer) != VK_SUCCESS)
+            throw std::runtime_error("failed to record secondary command buffer!");
+        frame.inlineCommandBuffer = VK_NULL_HANDLE;
+    }
+
+    VkCommandBuffer RendererAPI::GetRecordingCommandBuffer() {
+        return t_recordingCommandBuffer ? t_recordingCommandBuffer : g_state.GetCurrentFrame().inlineCommandBuffer;
+    }
+
+    void RendererAPI::SetViewportAndScissor(VkCommandBuffer commandBuffer) {
         VkViewport viewport = {
             .x = 0.0f,
             .y = static_cast<float>(g_state.swapchainExtent.height),
@@ -154,20 +285,39 @@ namespace mc
             .minDepth = 0.0f,
             .maxDepth = 1.0f,
         };
-        vkCmdSetViewport(frame.commandBuffer, 0, 1, &viewport);
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
         VkRect2D scissor = {
             .offset = {0, 0},
             .extent = g_state.swapchainExtent,
         };
-        vkCmdSetScissor(frame.commandBuffer, 0, 1, &scissor);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     }
 
     void RendererAPI::EndFrame() {
+        MC_PROFILE_SCOPE("RendererAPI::EndFrame");
         FrameData& frame = g_state.GetCurrentFrame();
 
+        EndInlineCommandBuffer(frame);
+        vkCmdExecuteCommands(frame.commandBuffer, (u32)frame.passCommandBuffers.size(), frame.passCommandBuffers.data());
+        frame.passCommandBuffers.clear();
         vkCmdEndRenderPass(frame.commandBuffer);
 
+        if(frame.timestampPool)
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, 2);
+
+        if(!g_state.pendingCapturePath.empty()) {
+            frame.capturePath = std::move(g_state.pendingCapturePath);
+            g_state.pendingCapturePath.clear();
+            RecordCapture(frame);
+        }
+
+        if(frame.timestampPool) {
+            vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, 3);
+            frame.timestampsWritten = true;
+        }
+        frame.frameIndex = g_state.frameIndex++;
+
         if(vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS)
             throw std::runtime_error("failed to record command buffer!");
 
@@ -189,35 +339,40 @@ namespace mc
             .pSignalSemaphores = signalSemaphores,
         };
 
+        // Nothing is acquired or presented without a swapchain
+        if(g_state.headless) {
+            submitInfo.waitSemaphoreCount = 0;
+            submitInfo.signalSemaphoreCount = 0;
+        }
 
         if(vkQueueSubmit(g_state.graphicsQueue, 1, &submitInfo, frame.renderFence) != VK_SUCCESS)
             throw std::runtime_error("failed to submit draw command buffer!");
 
-        VkSwapchainKHR swapChains[] = {g_state.swapchain};
-        VkPresentInfoKHR presentInfo = {
-            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+        if(!g_state.headless) {
+            VkSwapchainKHR swapChains[] = {g_state.swapchain};
+            VkPresentInfoKHR presentInfo = {
+                .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
 
-            .waitSemaphoreCount = 1,
-            .pWaitSemaphores = signalSemaphores,
+                .waitSemaphoreCount = 1,
+                .pWaitSemaphores = signalSemaphores,
 
-            .swapchainCount = 1,
-            .pSwapchains = swapChains,
+                .swapchainCount = 1,
+                .pSwapchains = swapChains,
 
-            .pImageIndices = &frame.currentImageIndex,
-        };
+                .pImageIndices = &frame.currentImageIndex,
+            };
 
-        VkResult result = vkQueuePresentKHR(g_state.presentQueue, &presentInfo);
+            VkResult result = vkQueuePresentKHR(g_state.presentQueue, &presentInfo);
 
-        if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || g_state.swapchainNeedsRecreation) {
-            g_state.swapchainNeedsRecreation = false;
-            RecreateSwapchain();
+            if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || g_state.swapchainNeedsRecreation) {
+                g_state.swapchainNeedsRecreation = false;
+                RecreateSwapchain();
+            }
+            else if(result != VK_SUCCESS)
+                throw std::runtime_error("failed to present swap chain image!");
         }
-        else if(result != VK_SUCCESS)
-            throw std::runtime_error("failed to present swap chain image!");
 
-        for(auto& fn : frame.afterSubmit)
-            fn();
-        frame.afterSubmit.clear();
+        DeletionQueue::RetireFrame(g_state.currentFrame);
         
         g_state.currentMaterial = nullptr;
         g_state.currentFrame = (g_state.currentFrame + 1) % FrameData::MAX_FRAMES_IN_FLIGHT;
@@ -229,6 +384,88 @@ namespace mc
         g_state.swapchainNeedsRecreation = true;
     }
 
+    bool RendererAPI::IsHeadless() {
+        return g_state.headless;
+    }
+
+    void RendererAPI::CaptureFrame(const std::filesystem::path& path) {
+        if(!g_state.headless)
+            throw std::runtime_error("Frame capture requires a headless renderer!");
+
+        g_state.pendingCapturePath = path;
+    }
+
+    GpuFrameTiming RendererAPI::GetLastGpuFrameTiming() {
+        return g_state.lastGpuFrameTiming;
+    }
+
+    void RendererAPI::RecordCapture(FrameData& frame) {
+        VkExtent2D extent = g_state.swapchainExtent;
+        u64 size = (u64)extent.width * extent.height * 4;
+
+        if(!frame.captureBuffer)
+            frame.captureBuffer = Buffer::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        // The render pass' external dependency orders its writes and final layout transition before the copy
+        VkBufferImageCopy region = {
+            .bufferOffset = 0,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageExtent = {extent.width, extent.height, 1},
+        };
+        vkCmdCopyImageToBuffer(frame.commandBuffer, g_state.swapchainImages[frame.currentImageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                               frame.captureBuffer->buffer, 1, &region);
+
+        VkMemoryBarrier toHost = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+        };
+        vkCmdPipelineBarrier(frame.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &toHost, 0, nullptr, 0, nullptr);
+    }
+
+    void RendererAPI::WriteCapture(FrameData& frame) {
+        if(frame.capturePath.empty())
+            return;
+
+        // Offscreen images are R8G8B8A8, so the copy already is in the byte order PngWriter takes
+        VkExtent2D extent = g_state.swapchainExtent;
+        PngWriter::Write(frame.capturePath, extent.width, extent.height,
+                         std::span((const u8*)frame.captureBuffer->mappedMemory, (u64)extent.width * extent.height * 4));
+        frame.capturePath.clear();
+    }
+
+    void RendererAPI::ReadTimestamps(FrameData& frame) {
+        if(!frame.timestampsWritten)
+            return;
+
+        frame.timestampsWritten = false;
+
+        std::array<u64, FrameData::TIMESTAMP_COUNT> timestamps{};
+        if(vkGetQueryPoolResults(g_state.device, frame.timestampPool, 0, FrameData::TIMESTAMP_COUNT, sizeof(timestamps), timestamps.data(),
+                                 sizeof(u64), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+            return;
+
+        u64 mask = g_state.timestampValidBits >= 64 ? ~0ull : (1ull << g_state.timestampValidBits) - 1;
+        auto toMilliseconds = [&](u32 first, u32 last) {
+            return (f32)((f64)((timestamps[last] - timestamps[first]) & mask) * g_state.timestampPeriod / 1e6);
+        };
+
+        g_state.lastGpuFrameTiming = {
+            .frameIndex = frame.frameIndex,
+            .milliseconds = toMilliseconds(0, 3),
+            .uploadMilliseconds = toMilliseconds(0, 1),
+            .renderPassMilliseconds = toMilliseconds(1, 2),
+        };
+    }
+
     Ref<Texture> RendererAPI::LoadTexture(const std::string& filePath, VkFilter filter) {
         i32 width, height, texChannels;
 
@@ -240,14 +477,9 @@ namespace mc
             throw std::runtime_error("failed to load texture image!");
 
         Ref<Texture> texture = CreateTexture(width, height, filter);
-        Ref<Buffer> stageBuffer = Buffer::CreateStageBuffer(imageSize);
-
-        void* data;
-        vkMapMemory(g_state.device, stageBuffer->memory, 0, imageSize, 0, &data);
-        memcpy(data, pixels, imageSize);
-        vkUnmapMemory(g_state.device, stageBuffer->memory);
+        StagingAllocation staging = StagingRing::Write(pixels, imageSize);
 
-        CopyBuffer(stageBuffer, texture, imageSize);
+        CopyBuffer(staging.buffer, texture, imageSize, staging.offset);
 
         stbi_image_free(pixels);
 
@@ -308,8 +540,8 @@ namespace mc
     }
 
     void RendererAPI::DeleteTexture(Ref<Texture> texture) {
-        vkDestroySampler(g_state.device, texture->sampler, g_state.allocator);
-        vkDestroyImageView(g_state.device, texture->imageView, g_state.allocator);
+        DeletionQueue::Push(texture->sampler);
+        DeletionQueue::Push(texture->imageView);
         DeleteImage(texture);
 
         *texture = {};
@@ -324,8 +556,7 @@ namespace mc
     }
 
     void RendererAPI::DeleteImage(Ref<AllocatedImage> image) {
-        vkFreeMemory(g_state.device, image->memory, g_state.allocator);
-        vkDestroyImage(g_state.device, image->image, g_state.allocator);
+        DeletionQueue::Push(image->image, image->memory);
 
         image->memory = VK_NULL_HANDLE;
         image->image = VK_NULL_HANDLE;
@@ -334,21 +565,21 @@ namespace mc
     }
 
     void RendererAPI::Draw(const Mat4& transform, Ref<Buffer> vertexBuffer) {
-        FrameData& frame = g_state.GetCurrentFrame();
+        VkCommandBuffer commandBuffer = GetRecordingCommandBuffer();
 
         MeshPushConstants pushConstants{transform};
 
         VkBuffer vertexBuffers[] = {vertexBuffer->buffer};
         VkDeviceSize offsets[] = {0};
 
-        vkCmdPushConstants(frame.commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshPushConstants), &pushConstants);
-        vkCmdBindVertexBuffers(frame.commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdPushConstants(commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshPushConstants), &pushConstants);
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 
-        vkCmdDraw(frame.commandBuffer, 3, 1, 0, 0);
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
     }
 
     void RendererAPI::Draw(const Mat4& transform, Ref<Buffer> vertexBuffer, Ref<Buffer> indexBuffer, u32 indicesCount) {
-        FrameData& frame = g_state.GetCurrentFrame();
+        VkCommandBuffer commandBuffer = GetRecordingCommandBuffer();
 
         MeshPushConstants pushConstants{transform};
 
@@ -357,28 +588,304 @@ namespace mc
 
         // vkCmdBindDescriptorSets(frame.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, g_state.pipelineLayout, 0, 1, &frame.uboDescriptor, 0, nullptr);
 
-        vkCmdPushConstants(frame.commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshPushConstants), &pushConstants);
+        vkCmdPushConstants(commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshPushConstants), &pushConstants);
 
-        vkCmdBindVertexBuffers(frame.commandBuffer, 0, 1, vertexBuffers, offsets);
-        vkCmdBindIndexBuffer(frame.commandBuffer, indexBuffer->buffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer->buffer, 0, VK_INDEX_TYPE_UINT32);
 
-        vkCmdDrawIndexed(frame.commandBuffer, indicesCount, 1, 0, 0, 0);
+        vkCmdDrawIndexed(commandBuffer, indicesCount, 1, 0, 0, 0);
     }
 
-    void RendererAPI::CopyBuffer(Ref<Buffer> srcBuffer, Ref<Buffer> dstBuffer, u64 size) {
-        SubmitImmediate([=](VkCommandBuffer cmd) {
-            VkBufferCopy copyRegion = {
-                .srcOffset = 0, // Optional
-                .dstOffset = 0, // Optional
-                .size = size,
+    void RendererAPI::DrawQuads(const Mat4& transform, Ref<Buffer> vertexBuffer, u32 quadCount, u32 firstQuad) {
+        if(quadCount > g_state.quadIndexCapacity)
+            throw std::runtime_error("Quad index buffer too small, missing RendererAPI::ReserveQuadIndices!");
+        
+        VkCommandBuffer commandBuffer = GetRecordingCommandBuffer();
+
+        MeshPushConstants pushConstants{transform};
+
+        VkBuffer vertexBuffers[] = {vertexBuffer->buffer};
+        VkDeviceSize offsets[] = {0};
+
+        vkCmdPushConstants(commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MeshPushConstants), &pushConstants);
+
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, g_state.quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT16);
+
+        // The shared indices are relative to the first vertex of the quad range
+        vkCmdDrawIndexed(commandBuffer, quadCount * 6, 1, 0, (i32)(firstQuad * 4), 0);
+    }
+
+    void RendererAPI::DrawChunkQuads(float3 origin, Ref<Buffer> vertexBuffer, u32 quadCount, u32 firstQuad) {
+        if(quadCount > g_state.quadIndexCapacity)
+            throw std::runtime_error("Quad index buffer too small, missing RendererAPI::ReserveQuadIndices!");
+        
+        VkCommandBuffer commandBuffer = GetRecordingCommandBuffer();
+
+        ChunkPushConstants pushConstants{origin};
+
+        VkBuffer vertexBuffers[] = {vertexBuffer->buffer};
+        VkDeviceSize offsets[] = {0};
+
+        vkCmdPushConstants(commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ChunkPushConstants), &pushConstants);
+
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, g_state.quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT16);
+
+        vkCmdDrawIndexed(commandBuffer, quadCount * 6, 1, 0, (i32)(firstQuad * 4), 0);
+    }
+
+    u32 RendererAPI::DrawQuadsIndirect(Ref<Buffer> vertexBuffer, std::span<const QuadDraw> draws, bool parallel) {
+        FrameData& frame = g_state.GetCurrentFrame();
+        VkCommandBuffer commandBuffer = GetRecordingCommandBuffer();
+
+        u32 firstDraw = frame.indirectDrawCount;
+        u32 drawCount = std::min((u32)draws.size(), FrameData::MAX_INDIRECT_DRAWS - firstDraw);
+
+        auto* commands = (VkDrawIndexedIndirectCommand*)frame.indirectBuffer->mappedMemory + firstDraw;
+        auto* origins = (float4*)frame.drawDataBuffer->mappedMemory + 1 + firstDraw;
+
+        auto writeDraws = [&](u32 begin, u32 end) {
+            for(u32 i = begin; i < end; i++) {
+                const QuadDraw& draw = draws[i];
+                if(draw.quadCount > g_state.quadIndexCapacity)
+                    throw std::runtime_error("Quad index buffer too small, missing RendererAPI::ReserveQuadIndices!");
+
+                commands[i] = {
+                    .indexCount = draw.quadCount * 6,
+                    .instanceCount = 1,
+                    .firstIndex = 0,
+                    .vertexOffset = (i32)(draw.firstQuad * 4),
+                    .firstInstance = 1 + firstDraw + i,
+                };
+                origins[i] = float4(draw.origin, 0);
+            }
+        };
+
+        // Every draw owns its slots in the indirect and draw data buffers, so slices write them without locking
+        u32 sliceCount = parallel ? GetRecordSliceCount(drawCount) : 1;
+        if(sliceCount <= 1)
+            writeDraws(0, drawCount);
+        else {
+            std::vector<std::exception_ptr> errors(sliceCount);
+
+            JobSystem::ParallelFor(sliceCount, [&](u32 slice) {
+                try {
+                    writeDraws((u32)((u64)drawCount * slice / sliceCount), (u32)((u64)drawCount * (slice + 1) / sliceCount));
+                }
+                catch(...) {
+                    errors[slice] = std::current_exception();
+                }
+            });
+
+            for(const std::exception_ptr& error : errors)
+                if(error)
+                    std::rethrow_exception(error);
+        }
+        frame.indirectDrawCount += drawCount;
+
+        if(drawCount > 0) {
+            // Positions are offset by the draw's origin from the draw data instead
+            ChunkPushConstants pushConstants{float3(0)};
+
+            VkBuffer vertexBuffers[] = {vertexBuffer->buffer};
+            VkDeviceSize offsets[] = {0};
+
+            vkCmdPushConstants(commandBuffer, g_state.currentMaterial->m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ChunkPushConstants), &pushConstants);
+
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+            vkCmdBindIndexBuffer(commandBuffer, g_state.quadIndexBuffer->buffer, 0, VK_INDEX_TYPE_UINT16);
+
+            u32 batchSize = g_state.multiDrawIndirect ? g_state.maxDrawIndirectCount : 1;
+            for(u32 first = 0; first < drawCount; first += batchSize)
+                vkCmdDrawIndexedIndirect(commandBuffer, frame.indirectBuffer->buffer, (firstDraw + first) * sizeof(VkDrawIndexedIndirectCommand),
+                                         std::min(batchSize, drawCount - first), sizeof(VkDrawIndexedIndirectCommand));
+        }
+
+        for(const QuadDraw& draw : draws.subspan(drawCount))
+            DrawChunkQuads(draw.origin, vertexBuffer, draw.quadCount, draw.firstQuad);
+
+        return sliceCount;
+    }
+
+    u32 RendererAPI::RecordParallel(u32 count, const std::function<void(u32 begin, u32 end)>& record) {
+        FrameData& frame = g_state.GetCurrentFrame();
+
+        u32 sliceCount = GetRecordSliceCount(count);
+        if(sliceCount <= 1) {
+            record(0, count);
+            return 1;
+        }
+
+        // Pools are per slice rather than per thread, a slice is recorded by exactly one thread at a time either way.
+        // Pool 0 belongs to the inline command buffer.
+        std::vector<VkCommandBuffer> commandBuffers(sliceCount);
+        for(u32 slice = 0; slice < sliceCount; slice++)
+            commandBuffers[slice] = AcquireSecondaryCommandBuffer(frame, slice + 1);
+
+        const Material* material = g_state.currentMaterial.get();
+        std::vector<std::exception_ptr> errors(sliceCount);
+
+        JobSystem::ParallelFor(sliceCount, [&](u32 slice) {
+            VkCommandBuffer commandBuffer = commandBuffers[slice];
+
+            try {
+                BeginSecondaryCommandBuffer(frame, commandBuffer);
+                if(material) {
+                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->m_pipeline);
+                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->m_pipelineLayout, 0, 1,
+                                            &material->m_descriptorSets[g_state.currentFrame], 0, nullptr);
+                }
+
+                t_recordingCommandBuffer = commandBuffer;
+                record((u32)((u64)count * slice / sliceCount), (u32)((u64)count * (slice + 1) / sliceCount));
+                t_recordingCommandBuffer = VK_NULL_HANDLE;
+
+                if(vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+                    throw std::runtime_error("failed to record secondary command buffer!");
+            }
+            catch(...) {
+                t_recordingCommandBuffer = VK_NULL_HANDLE;
+                errors[slice] = std::current_exception();
+            }
+        });
+
+        for(const std::exception_ptr& error : errors)
+            if(error)
+                std::rethrow_exception(error);
+
+        // The slices go between what was recorded inline so far and what follows, in a fresh inline command buffer
+        EndInlineCommandBuffer(frame);
+        frame.passCommandBuffers.insert(frame.passCommandBuffers.end(), commandBuffers.begin(), commandBuffers.end());
+        BeginInlineCommandBuffer(frame);
+
+        if(material) {
+            vkCmdBindPipeline(frame.inlineCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->m_pipeline);
+            vkCmdBindDescriptorSets(frame.inlineCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->m_pipelineLayout, 0, 1,
+                                    &material->m_descriptorSets[g_state.currentFrame], 0, nullptr);
+        }
+
+        return sliceCount;
+    }
+
+    u32 RendererAPI::GetRecordSliceCount(u32 count) {
+        return std::max(1u, std::min(JobSystem::GetWorkerCount() + 1, count / MIN_RECORD_SLICE_SIZE));
+    }
+
+    VkCommandBuffer RendererAPI::AcquireSecondaryCommandBuffer(FrameData& frame, u32 poolIndex) {
+        while(frame.secondaryPools.size() <= poolIndex) {
+            VkCommandPoolCreateInfo poolInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                .queueFamilyIndex = g_state.indices.graphicsFamily,
+            };
+
+            SecondaryCommandPool& pool = frame.secondaryPools.emplace_back();
+            if(vkCreateCommandPool(g_state.device, &poolInfo, g_state.allocator, &pool.commandPool) != VK_SUCCESS)
+                throw std::runtime_error("failed to create command pool!");
+        }
+
+        SecondaryCommandPool& pool = frame.secondaryPools[poolIndex];
+        if(pool.usedCount == pool.commandBuffers.size()) {
+            VkCommandBufferAllocateInfo allocInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = pool.commandPool,
+                .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                .commandBufferCount = 1,
             };
 
-            vkCmdCopyBuffer(cmd, srcBuffer->buffer, dstBuffer->buffer, 1, &copyRegion);
+            if(vkAllocateCommandBuffers(g_state.device, &allocInfo, &pool.commandBuffers.emplace_back()) != VK_SUCCESS)
+                throw std::runtime_error("failed to allocate command buffers!");
+        }
+
+        return pool.commandBuffers[pool.usedCount++];
+    }
+
+    bool RendererAPI::SupportsIndirectDraw() {
+        return g_state.drawIndirectFirstInstance;
+    }
+
+    void RendererAPI::ReserveQuadIndices(u32 quadCount) {
+        if(quadCount <= g_state.quadIndexCapacity)
+            return;
+
+        // u16 indices address at most 65536 vertices, far more than a chunk mesh can have
+        constexpr u32 MAX_QUADS = (1u << 16) / 4;
+        if(quadCount > MAX_QUADS)
+            throw std::runtime_error("Quad meshes are limited to 16384 quads!");
+
+        u32 capacity = std::clamp(std::bit_ceil(quadCount), 1024u, MAX_QUADS);
+        
+        std::vector<u16> indices;
+        indices.reserve(capacity * 6ull);
+        for(u32 quad = 0; quad < capacity; quad++) {
+            u16 first = (u16)(quad * 4);
+            indices.insert(indices.end(), {(u16)(first + 0), (u16)(first + 3), (u16)(first + 1),
+                                           (u16)(first + 0), (u16)(first + 2), (u16)(first + 3)});
+        }
+
+        // The old buffer is retired once the frames drawing with it completed
+        g_state.quadIndexBuffer = Buffer::CreateIndexBuffer(std::span(indices));
+        g_state.quadIndexCapacity = capacity;
+    }
+
+    void RendererAPI::CopyBuffer(Ref<Buffer> srcBuffer, Ref<Buffer> dstBuffer, u64 size, u64 srcOffset, u64 dstOffset) {
+        g_state.pendingBufferCopies.push_back({
+            .srcBuffer = std::move(srcBuffer),
+            .dstBuffer = std::move(dstBuffer),
+            .region = {
+                .srcOffset = srcOffset,
+                .dstOffset = dstOffset,
+                .size = size,
+            },
         });
     }
 
-    void RendererAPI::CopyBuffer(Ref<Buffer> srcBuffer, Ref<AllocatedImage> dstImage, u64 size) {
-        SubmitImmediate([=](VkCommandBuffer cmd) {
+    void RendererAPI::CopyBuffer(Ref<Buffer> srcBuffer, Ref<AllocatedImage> dstImage, u64 size, u64 srcOffset) {
+        g_state.pendingImageCopies.push_back({
+            .srcBuffer = std::move(srcBuffer),
+            .dstImage = std::move(dstImage),
+            .srcOffset = srcOffset,
+            .size = size,
+        });
+    }
+
+    u32 RendererAPI::GetLastUploadCount() {
+        return g_state.lastUploadCount;
+    }
+
+    u64 RendererAPI::GetLastUploadBytes() {
+        return g_state.lastUploadBytes;
+    }
+
+    void RendererAPI::RecordUploads(FrameData& frame) {
+        g_state.lastUploadCount = (u32)(g_state.pendingBufferCopies.size() + g_state.pendingImageCopies.size());
+        g_state.lastUploadBytes = 0;
+        
+        if(g_state.lastUploadCount == 0)
+            return;
+
+        VkCommandBuffer cmd = frame.commandBuffer;
+        constexpr VkPipelineStageFlags READ_STAGES = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        // Copies only ever target freshly created buffers and images or freshly allocated GeometryArena ranges,
+        // nothing in flight reads them, so no barrier is needed in front of them
+        for(PendingBufferCopy& copy : g_state.pendingBufferCopies) {
+            // Copies keep their buffers alive, only an explicit Buffer::Delete can pull them away
+            if(!copy.srcBuffer->buffer || !copy.dstBuffer->buffer)
+                throw std::runtime_error("Buffer deleted before its pending copy was recorded!");
+
+            vkCmdCopyBuffer(cmd, copy.srcBuffer->buffer, copy.dstBuffer->buffer, 1, &copy.region);
+            g_state.lastUploadBytes += copy.region.size;
+
+            frame.uploadBuffers.push_back(std::move(copy.srcBuffer));
+            frame.uploadBuffers.push_back(std::move(copy.dstBuffer));
+        }
+
+        for(PendingImageCopy& copy : g_state.pendingImageCopies) {
+            if(!copy.srcBuffer->buffer)
+                throw std::runtime_error("Buffer deleted before its pending copy was recorded!");
+
             VkImageSubresourceRange range = {
                 .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                 .baseMipLevel = 0,
@@ -395,7 +902,7 @@ namespace mc
 
                 .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
                 .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .image = dstImage->image,
+                .image = copy.dstImage->image,
                 .subresourceRange = range,
             };
 
@@ -404,7 +911,7 @@ namespace mc
                                  0, nullptr, 1, &imageBarrier_toTransfer);
 
             VkBufferImageCopy copyRegion = {
-                .bufferOffset = 0,
+                .bufferOffset = copy.srcOffset,
                 .bufferRowLength = 0,
                 .bufferImageHeight = 0,
 
@@ -414,11 +921,11 @@ namespace mc
                     .baseArrayLayer = 0,
                     .layerCount = 1,
                 },
-                .imageExtent = dstImage->extent,
+                .imageExtent = copy.dstImage->extent,
             };
 
             //copy the buffer into the image
-            vkCmdCopyBufferToImage(cmd, srcBuffer->buffer, dstImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+            vkCmdCopyBufferToImage(cmd, copy.srcBuffer->buffer, copy.dstImage->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
 
             VkImageMemoryBarrier imageBarrier_toReadable = imageBarrier_toTransfer;
 
@@ -431,7 +938,21 @@ namespace mc
             //barrier the image into the shader readable layout
             vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0,
                                  nullptr, 0, nullptr, 1, &imageBarrier_toReadable);
-        });
+
+            g_state.lastUploadBytes += copy.size;
+            frame.uploadBuffers.push_back(std::move(copy.srcBuffer));
+        }
+
+        g_state.pendingBufferCopies.clear();
+        g_state.pendingImageCopies.clear();
+
+        // Make the copies visible to everything the render pass reads
+        VkMemoryBarrier toRead = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+        };
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, READ_STAGES, 0, 1, &toRead, 0, nullptr, 0, nullptr);
     }
 
     void RendererAPI::SubmitImmediate(std::function<void(VkCommandBuffer cmd)>&& function) {
@@ -477,14 +998,6 @@ namespace mc
         vkResetCommandPool(g_state.device, g_state.uploadContext.commandPool, 0);
     }
 
-    void RendererAPI::SubmitAfterFrame(std::function<void()>&& function) {
-        g_state.frames[(g_state.currentFrame - 1 + FrameData::MAX_FRAMES_IN_FLIGHT) % FrameData::MAX_FRAMES_IN_FLIGHT].afterSubmit.push_back(std::move(function));
-    }
-
-    void RendererAPI::SubmitNextFrame(std::function<void(VkCommandBuffer cmd)>&& function) {
-        g_state.nextFrameSubmits.push_back(std::move(function));
-    }
-
     GlobalState& RendererAPI::GetState() {
         return g_state;
     }
@@ -497,7 +1010,8 @@ namespace mc
         // Instance
         VkApplicationInfo appInfo = {
             .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
-            .pApplicationName = Application::Get().name.c_str(),
+            // There is no Application when rendering headless
+            .pApplicationName = g_state.headless ? "MineClone" : Application::Get().name.c_str(),
             .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
             .pEngineName = "No Engine",
             .engineVersion = VK_MAKE_VERSION(1, 0, 0),
@@ -623,15 +1137,30 @@ namespace mc
                 .pQueuePriorities = &queuePriority
             });
 
-        VkPhysicalDeviceFeatures deviceFeatures = {};
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(g_state.physicalDevice, &supportedFeatures);
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(g_state.physicalDevice, &properties);
+
+        VkPhysicalDeviceFeatures deviceFeatures = {
+            .multiDrawIndirect = supportedFeatures.multiDrawIndirect,
+            .drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance,
+        };
+
+        g_state.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        g_state.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+        g_state.maxDrawIndirectCount = supportedFeatures.multiDrawIndirect ? std::max(properties.limits.maxDrawIndirectCount, 1u) : 1;
+
+        std::vector<const char*> extensions = details::VulkanUtils::GetRequiredDeviceExtensions();
 
         VkDeviceCreateInfo createInfo = {
             .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
             .queueCreateInfoCount = static_cast<u32>(queueCreateInfos.size()),
             .pQueueCreateInfos = queueCreateInfos.data(),
 
-            .enabledExtensionCount = static_cast<u32>(DEVICE_EXTENSIONS.size()),
-            .ppEnabledExtensionNames = DEVICE_EXTENSIONS.data(),
+            .enabledExtensionCount = static_cast<u32>(extensions.size()),
+            .ppEnabledExtensionNames = extensions.data(),
 
             .pEnabledFeatures = &deviceFeatures,
         };
@@ -654,6 +1183,58 @@ namespace mc
         vkGetDeviceQueue(g_state.device, g_state.indices.presentFamily, 0, &g_state.presentQueue);
     }
 
+    void RendererAPI::CreatePipelineCache() {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(g_state.physicalDevice, &properties);
+
+        std::vector<byte> data;
+        if(std::filesystem::exists(Config::PIPELINE_CACHE_PATH))
+            data = details::VulkanUtils::ReadFile(std::string(Config::PIPELINE_CACHE_PATH));
+
+        // Drivers should reject foreign data themselves, but not all of them do so gracefully
+        VkPipelineCacheHeaderVersionOne header{};
+        if(data.size() >= sizeof(header))
+            memcpy(&header, data.data(), sizeof(header));
+
+        bool valid = data.size() >= sizeof(header)
+            && header.headerSize >= sizeof(header)
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == properties.vendorID
+            && header.deviceID == properties.deviceID
+            && memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+        if(!valid)
+            data.clear();
+        g_state.pipelineCacheLoaded = valid;
+
+        VkPipelineCacheCreateInfo createInfo = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = data.size(),
+            .pInitialData = data.data(),
+        };
+
+        if(vkCreatePipelineCache(g_state.device, &createInfo, g_state.allocator, &g_state.pipelineCache) != VK_SUCCESS)
+            throw std::runtime_error("failed to create pipeline cache!");
+    }
+
+    void RendererAPI::SavePipelineCache() {
+        size_t size = 0;
+        vkGetPipelineCacheData(g_state.device, g_state.pipelineCache, &size, nullptr);
+
+        std::vector<byte> data(size);
+        if(vkGetPipelineCacheData(g_state.device, g_state.pipelineCache, &size, data.data()) != VK_SUCCESS)
+            return;
+
+        // Losing the cache only costs the next startup some time, so this does not throw during shutdown
+        std::ofstream file(std::filesystem::path(Config::PIPELINE_CACHE_PATH), std::ios::binary);
+        if(!file) {
+            std::cout << std::format("failed to write pipeline cache to {}\n", Config::PIPELINE_CACHE_PATH);
+            return;
+        }
+
+        file.write((const char*)data.data(), (std::streamsize)size);
+    }
+
     void RendererAPI::CreateSwapchain() {
         VkSurfaceFormatKHR surfaceFormat = g_state.swapchainSupportDetails.formats[0];
         for(const auto& availableFormat : g_state.swapchainSupportDetails.formats)
@@ -729,6 +1310,20 @@ namespace mc
         g_state.swapchainImageFormat = surfaceFormat.format;
     }
 
+    void RendererAPI::CreateOffscreenImages() {
+        g_state.swapchainImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+
+        // Frames index these with currentFrame, a target is only reused once its frame's fence signaled
+        for(u32 i = 0; i < FrameData::MAX_FRAMES_IN_FLIGHT; i++) {
+            Ref<AllocatedImage> image = CreateRef<AllocatedImage>();
+            CreateImage(image, g_state.swapchainExtent.width, g_state.swapchainExtent.height, g_state.swapchainImageFormat,
+                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
+            g_state.offscreenImages.push_back(image);
+            g_state.swapchainImages.push_back(image->image);
+        }
+    }
+
     void RendererAPI::CreateImageViews() {
         // Image Views
         u64 imageCount = g_state.swapchainImages.size();
@@ -769,7 +1364,8 @@ namespace mc
             .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
             .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
             .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-            .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            // Offscreen images are only ever copied from, see RendererAPI::CaptureFrame
+            .finalLayout = g_state.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
         };
 
         VkAttachmentDescription depthAttachment = {
@@ -801,12 +1397,24 @@ namespace mc
             .pDepthStencilAttachment = &depthAttachmentRef,
         };
 
+        // Headless frames are copied out right after the pass, see RendererAPI::RecordCapture
+        VkSubpassDependency captureDependency = {
+            .srcSubpass = 0,
+            .dstSubpass = VK_SUBPASS_EXTERNAL,
+            .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        };
+
         VkRenderPassCreateInfo renderPassInfo = {
             .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
             .attachmentCount = static_cast<u32>(attachments.size()),
             .pAttachments = attachments.data(),
             .subpassCount = 1,
             .pSubpasses = &subpass,
+            .dependencyCount = g_state.headless ? 1u : 0u,
+            .pDependencies = g_state.headless ? &captureDependency : nullptr,
         };
 
         if(vkCreateRenderPass(g_state.device, &renderPassInfo, g_state.allocator, &g_state.renderPass) != VK_SUCCESS)
@@ -934,14 +1542,49 @@ namespace mc
             throw std::runtime_error("failed to create fence!");
     }
 
+    void RendererAPI::CreateQueryPools() {
+        u32 queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(g_state.physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(g_state.physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(g_state.physicalDevice, &properties);
+
+        g_state.timestampValidBits = queueFamilies[g_state.indices.graphicsFamily].timestampValidBits;
+        g_state.timestampPeriod = properties.limits.timestampPeriod;
+
+        if(g_state.timestampValidBits == 0)
+            return;
+
+        VkQueryPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = FrameData::TIMESTAMP_COUNT,
+        };
+
+        for(FrameData& frame : g_state.frames)
+            if(vkCreateQueryPool(g_state.device, &poolInfo, g_state.allocator, &frame.timestampPool) != VK_SUCCESS)
+                throw std::runtime_error("failed to create query pool!");
+    }
+
     void RendererAPI::CreateUniformBuffers() {
         // ReSharper disable once CppTooWideScope
         u64 bufferSize = sizeof(UniformBufferObject);
-        for(FrameData& frame : g_state.frames) {
+        for(FrameData& frame : g_state.frames)
             frame.uboBuffer = Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
 
-            vkMapMemory(g_state.device, frame.uboBuffer->memory, 0, bufferSize, 0, &frame.uboBuffer->mappedMemory);
+    void RendererAPI::CreateIndirectBuffers() {
+        for(FrameData& frame : g_state.frames) {
+            frame.indirectBuffer = Buffer::CreateBuffer(FrameData::MAX_INDIRECT_DRAWS * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+            u64 drawDataSize = (FrameData::MAX_INDIRECT_DRAWS + 1) * sizeof(float4);
+            frame.drawDataBuffer = Buffer::CreateBuffer(drawDataSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            memset(frame.drawDataBuffer->mappedMemory, 0, drawDataSize);
         }
     }
 
@@ -1053,6 +1696,13 @@ namespace mc
         for(size_t i = 0; i < g_state.swapchainImageViews.size(); i++)
             vkDestroyImageView(g_state.device, g_state.swapchainImageViews[i], g_state.allocator);
 
-        vkDestroySwapchainKHR(g_state.device, g_state.swapchain, g_state.allocator);
+        if(g_state.headless) {
+            for(Ref<AllocatedImage>& image : g_state.offscreenImages)
+                DeleteImage(image);
+            g_state.offscreenImages.clear();
+            g_state.swapchainImages.clear();
+        }
+        else
+            vkDestroySwapchainKHR(g_state.device, g_state.swapchain, g_state.allocator);
     }
 }
@@ -7,6 +7,7 @@
 namespace mc
 {
     struct GlobalState;
+    struct FrameData;
 
     namespace details
     {
@@ -17,18 +18,30 @@ namespace mc
     {
     public:
         static void Init();
+        // Renders into offscreen images of the given size instead of the Application window, no window or GLFW needed.
+        // Also runs on software implementations such as lavapipe, selected through VK_ICD_FILENAMES.
+        static void InitHeadless(u32 width, u32 height);
         static void Deinit();
         static void Wait();
 
         static void BeginFrame(float deltaTime, const Camera& camera);
         static void EndFrame();
 
+        static bool IsHeadless();
+        // Copies the color target of the next frame ended by EndFrame into a PNG file, written once that frame completed
+        // on the GPU or at Deinit. Headless only.
+        static void CaptureFrame(const std::filesystem::path& path);
+
+        // Lags FrameData::MAX_FRAMES_IN_FLIGHT frames behind the frame being recorded
+        static GpuFrameTiming GetLastGpuFrameTiming();
+
         static void Resize(u32 width, u32 height);
 
 
         static Ref<Texture> LoadTexture(const std::string& filePath, VkFilter filter = VK_FILTER_LINEAR);
         static Ref<Texture> CreateTexture(u32 width, u32 height, VkFilter filter = VK_FILTER_LINEAR, VkFormat format = VK_FORMAT_R8G8B8A8_SRGB);
 
+        // Destruction is deferred through the DeletionQueue
         static void DeleteTexture(Ref<Texture> texture);
 
 
@@ -38,16 +51,43 @@ namespace mc
 
         static void Draw(const Mat4& transform, Ref<Buffer> vertexBuffer);
         static void Draw(const Mat4& transform, Ref<Buffer> vertexBuffer, Ref<Buffer> indexBuffer, u32 indicesCount);
-
-        static void CopyBuffer(Ref<Buffer> srcBuffer, Ref<Buffer> dstBuffer, u64 size);
-        static void CopyBuffer(Ref<Buffer> srcBuffer, Ref<AllocatedImage> dstImage, u64 size);
+        // Draws quadCount quads of 4 vertices each using the shared quad index buffer, starting at quad firstQuad
+        static void DrawQuads(const Mat4& transform, Ref<Buffer> vertexBuffer, u32 quadCount, u32 firstQuad = 0);
+        // Same as DrawQuads for materials using ChunkPushConstants, which only take a translation
+        static void DrawChunkQuads(float3 origin, Ref<Buffer> vertexBuffer, u32 quadCount, u32 firstQuad = 0);
+
+        // Draws every range of vertexBuffer with vkCmdDrawIndexedIndirect, as one call per batch with multiDrawIndirect and
+        // one per range without. Uses ChunkPushConstants, draws beyond FrameData::MAX_INDIRECT_DRAWS in a frame fall back to DrawChunkQuads.
+        // When parallel the commands are written in slices on the JobSystem like RecordParallel, returns the slice count.
+        static u32 DrawQuadsIndirect(Ref<Buffer> vertexBuffer, std::span<const QuadDraw> draws, bool parallel = false);
+
+        // Splits [0, count) into one slice per JobSystem thread and calls record for every slice on the workers. Draw calls made
+        // by record go into a secondary command buffer per slice with the current material bound, executed in slice order
+        // between the draws recorded before and after. Only the draws above are allowed inside record. Returns the slice count, 1 when recorded inline.
+        static u32 RecordParallel(u32 count, const std::function<void(u32 begin, u32 end)>& record);
+        // Indirect draws select their origin through firstInstance, which is an optional device feature
+        static bool SupportsIndirectDraw();
+
+        // Grows the shared quad index buffer, must be called before recording draws of that many quads
+        static void ReserveQuadIndices(u32 quadCount);
+
+        // Copies are batched and recorded ahead of the render pass of the next BeginFrame, they never block
+        static void CopyBuffer(Ref<Buffer> srcBuffer, Ref<Buffer> dstBuffer, u64 size, u64 srcOffset = 0, u64 dstOffset = 0);
+        static void CopyBuffer(Ref<Buffer> srcBuffer, Ref<AllocatedImage> dstImage, u64 size, u64 srcOffset = 0);
+
+        // Copies and bytes recorded by the last BeginFrame
+        static u32 GetLastUploadCount();
+        static u64 GetLastUploadBytes();
 
         static void SubmitImmediate(std::function<void(VkCommandBuffer cmd)>&& function);
-        static void SubmitAfterFrame(std::function<void()>&& function);
-        static void SubmitNextFrame(std::function<void(VkCommandBuffer cmd)>&& function);
 
         static GlobalState& GetState();
     private:
+        // Fewer items per slice are recorded inline, extra secondary command buffers would cost more than they save
+        static constexpr u32 MIN_RECORD_SLICE_SIZE = 32;
+
+        // Everything after the surface, shared by Init and InitHeadless
+        static void CreateDeviceObjects();
 
         static void CreateInstance();
         static void SetupDebugMessenger();
@@ -55,7 +95,10 @@ namespace mc
 
         static void PickPhysicalDevice();
         static void CreateLogicalDevice();
+        static void CreatePipelineCache();
+        static void SavePipelineCache();
         static void CreateSwapchain();
+        static void CreateOffscreenImages();
         static void CreateImageViews();
         static void CreateRenderPass();
         static void CreateDescriptorPool();
@@ -63,8 +106,24 @@ namespace mc
         static void CreateCommandPool();
         static void CreateCommandBuffers();
         static void CreateSyncObjects();
+        static void CreateQueryPools();
+
+        static void BeginRenderPass(FrameData& frame);
+        static void BeginSecondaryCommandBuffer(FrameData& frame, VkCommandBuffer commandBuffer);
+        static void BeginInlineCommandBuffer(FrameData& frame);
+        static void EndInlineCommandBuffer(FrameData& frame);
+        static void SetViewportAndScissor(VkCommandBuffer commandBuffer);
+        static u32 GetRecordSliceCount(u32 count);
+        static VkCommandBuffer AcquireSecondaryCommandBuffer(FrameData& frame, u32 poolIndex);
+        // The current RecordParallel slice's command buffer, or the frame's inline one
+        static VkCommandBuffer GetRecordingCommandBuffer();
 
         static void CreateUniformBuffers();
+        static void CreateIndirectBuffers();
+        static void RecordUploads(FrameData& frame);
+        static void RecordCapture(FrameData& frame);
+        static void WriteCapture(FrameData& frame);
+        static void ReadTimestamps(FrameData& frame);
         static void CreateImage(Ref<AllocatedImage> image, u32 width, u32 height, VkFormat format, VkImageUsageFlags usage);
 
         static void CreateDepthBuffer();
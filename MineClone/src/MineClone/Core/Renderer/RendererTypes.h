@@ -20,6 +20,8 @@ namespace mc
         float4 data;
         Mat4 proj;
         Mat4 view;
+        // proj * view, multiplied once per frame instead of per vertex
+        Mat4 viewProj;
     };
 
     struct MeshPushConstants
@@ -27,6 +29,32 @@ namespace mc
         Mat4 model;
     };
 
+    // Chunks are only ever translated, so chunk.vert gets their origin instead of a model matrix
+    struct ChunkPushConstants
+    {
+        float3 origin;
+    };
+
+    // Quad range of a vertex buffer drawn by RendererAPI::DrawQuadsIndirect, origin is added to its vertex positions
+    struct QuadDraw
+    {
+        u32 firstQuad;
+        u32 quadCount;
+        float3 origin;
+    };
+
+    // GPU time of one frame's command buffer from timestamp queries, see RendererAPI::GetLastGpuFrameTiming
+    struct GpuFrameTiming
+    {
+        // Counts frames submitted by RendererAPI::EndFrame, starting at 0
+        u64 frameIndex = 0;
+        // Negative when the graphics queue does not support timestamps or no frame completed yet
+        f32 milliseconds = -1.f;
+        // Copies and submits recorded ahead of the render pass, then the render pass itself
+        f32 uploadMilliseconds = 0;
+        f32 renderPassMilliseconds = 0;
+    };
+
     struct RenderObject
     {
         // Ref<Mesh> mesh;
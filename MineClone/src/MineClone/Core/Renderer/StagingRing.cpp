@@ -0,0 +1,59 @@
+﻿#include "mcpch.h"
+#include "StagingRing.h"
+
+#include "Buffer.h"
+#include "VulkanTypes.h"
+
+namespace mc
+{
+    void StagingRing::Init(u64 size) {
+        static_assert(std::tuple_size_v<decltype(s_frameHeads)> == FrameData::MAX_FRAMES_IN_FLIGHT);
+
+        s_capacity = size;
+        s_buffer = Buffer::CreateStageBuffer(size);
+
+        s_head = 0;
+        s_tail = 0;
+        s_frameHeads.fill(0);
+    }
+
+    void StagingRing::Deinit() {
+        s_buffer->Delete();
+        s_buffer = nullptr;
+        s_capacity = 0;
+    }
+
+    StagingAllocation StagingRing::Allocate(u64 size) {
+        u64 position = (s_head + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+        // Never split an allocation across the end of the ring, skip to its start instead
+        if(position % s_capacity + size > s_capacity)
+            position += s_capacity - position % s_capacity;
+
+        if(position + size - s_tail > s_capacity) {
+            s_overflowCount++;
+
+            Ref<Buffer> buffer = Buffer::CreateStageBuffer(size);
+            return {buffer, 0, buffer->mappedMemory};
+        }
+
+        s_head = position + size;
+
+        u64 offset = position % s_capacity;
+        return {s_buffer, offset, (byte*)s_buffer->mappedMemory + offset};
+    }
+
+    StagingAllocation StagingRing::Write(const void* data, u64 size) {
+        StagingAllocation allocation = Allocate(size);
+        memcpy(allocation.data, data, size);
+        return allocation;
+    }
+
+    void StagingRing::ReclaimFrame(u32 frameIndex) {
+        s_tail = std::max(s_tail, s_frameHeads[frameIndex]);
+    }
+
+    void StagingRing::MarkFrame(u32 frameIndex) {
+        s_frameHeads[frameIndex] = s_head;
+    }
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+namespace mc
+{
+    class Buffer;
+
+    // Slice of staging memory, data is mapped and can be written directly before the copy is recorded
+    struct StagingAllocation
+    {
+        Ref<Buffer> buffer;
+        u64 offset = 0;
+        void* data = nullptr;
+    };
+
+    // Persistently mapped ring of host visible memory all uploads are staged through.
+    // Space is handed out linearly and wraps around, the range a frame used is reclaimed once its fence signals.
+    // Uploads that do not fit in the free space fall back to a dedicated staging buffer.
+    // Main thread only.
+    class StagingRing
+    {
+    public:
+        static void Init(u64 size);
+        static void Deinit();
+
+        static StagingAllocation Allocate(u64 size);
+        static StagingAllocation Write(const void* data, u64 size);
+
+        // Called once the fence of frameIndex signaled / once its uploads were recorded into its command buffer
+        static void ReclaimFrame(u32 frameIndex);
+        static void MarkFrame(u32 frameIndex);
+
+    public:
+        static u64 GetCapacity() { return s_capacity; }
+        static u64 GetUsedBytes() { return s_head - s_tail; }
+        static u64 GetOverflowCount() { return s_overflowCount; }
+
+    private:
+        static constexpr u64 ALIGNMENT = 16;
+
+        inline static Ref<Buffer> s_buffer;
+        inline static u64 s_capacity = 0;
+
+        // Monotonic byte positions, the ring offset is position % capacity
+        inline static u64 s_head = 0;
+        inline static u64 s_tail = 0;
+        inline static std::array<u64, 2> s_frameHeads{};
+
+        inline static u64 s_overflowCount = 0;
+    };
+}
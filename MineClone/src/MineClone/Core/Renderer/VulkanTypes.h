@@ -48,9 +48,34 @@ namespace mc
         std::vector<VkPresentModeKHR> presentModes;
     };
 
+    // Copies issued through RendererAPI::CopyBuffer, recorded at the start of the next frame's command buffer
+    struct PendingBufferCopy
+    {
+        Ref<Buffer> srcBuffer;
+        Ref<Buffer> dstBuffer;
+        VkBufferCopy region;
+    };
+
+    struct PendingImageCopy
+    {
+        Ref<Buffer> srcBuffer;
+        Ref<AllocatedImage> dstImage;
+        u64 srcOffset;
+        u64 size;
+    };
+
+    // Secondary command buffers of the inline recording or of one RendererAPI::RecordParallel slice, reset together once the frame's fence signaled
+    struct SecondaryCommandPool
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> commandBuffers;
+        u32 usedCount = 0;
+    };
+
     struct FrameData
     {
         static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+        static constexpr u32 MAX_INDIRECT_DRAWS = 1 << 16;
 
         VkSemaphore presentSemaphore = VK_NULL_HANDLE;
         VkSemaphore renderSemaphore = VK_NULL_HANDLE;
@@ -60,11 +85,33 @@ namespace mc
 
         VkCommandPool commandPool = VK_NULL_HANDLE;
         VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        // Created on demand, the first for inline recording and one per slice of RendererAPI::RecordParallel
+        std::vector<SecondaryCommandPool> secondaryPools;
+        // The render pass only executes secondary command buffers, draws outside RecordParallel go to the inline one
+        VkCommandBuffer inlineCommandBuffer = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> passCommandBuffers;
 
         UniformBufferObject ubo;
         Ref<Buffer> uboBuffer;
-        
-        std::vector<std::function<void()>> afterSubmit;
+
+        // Host visible VkDrawIndexedIndirectCommand array and the float4 origin of every indirect draw.
+        // Origin 0 stays zero for direct draws, indirect draw i reads origin i + 1 through its firstInstance.
+        Ref<Buffer> indirectBuffer;
+        Ref<Buffer> drawDataBuffer;
+        u32 indirectDrawCount = 0;
+
+        // Buffers the frame's uploads touch, kept alive until its fence signals
+        std::vector<Ref<Buffer>> uploadBuffers;
+
+        // Start of the command buffer, start and end of the render pass and end of the command buffer, read back once the fence signaled
+        static constexpr u32 TIMESTAMP_COUNT = 4;
+        VkQueryPool timestampPool = VK_NULL_HANDLE;
+        bool timestampsWritten = false;
+        u64 frameIndex = 0;
+
+        // Host visible copy of the color target and the file it goes to, see RendererAPI::CaptureFrame
+        Ref<Buffer> captureBuffer;
+        std::filesystem::path capturePath;
     };
 
     struct GlobalState
@@ -86,6 +133,10 @@ namespace mc
 
         VkDescriptorPool descriptorPool;
 
+        // Loaded from Config::PIPELINE_CACHE_PATH, loaded is false when there was no file or it belongs to another device or driver
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+        bool pipelineCacheLoaded = false;
+
         VkRenderPass renderPass;
 
         std::vector<VkImage> swapchainImages;
@@ -103,14 +154,39 @@ namespace mc
         bool swapchainNeedsRecreation = false;
         uint2 currentWindowSize;
 
+        // Frames render into offscreenImages, one per frame in flight, instead of a window surface. See RendererAPI::InitHeadless
+        bool headless = false;
+        std::vector<Ref<AllocatedImage>> offscreenImages;
+        // Picked up by the next EndFrame
+        std::filesystem::path pendingCapturePath;
+
+        // Zero valid bits when the graphics queue does not support timestamps
+        u32 timestampValidBits = 0;
+        f32 timestampPeriod = 0;
+        GpuFrameTiming lastGpuFrameTiming;
+        u64 frameIndex = 0;
+
         QueueFamilyIndices indices;
+
+        // Optional device features DrawQuadsIndirect relies on
+        bool multiDrawIndirect = false;
+        bool drawIndirectFirstInstance = false;
+        u32 maxDrawIndirectCount = 1;
         SwapchainSupportDetails swapchainSupportDetails;
 
         VkAllocationCallbacks* allocator = nullptr;
         std::vector<VkExtensionProperties> extensions;
 
+        // Shared u16 index buffer with the 0,3,1,0,2,3 pattern of every quad, see RendererAPI::DrawQuads
+        Ref<Buffer> quadIndexBuffer;
+        u32 quadIndexCapacity = 0;
+
         UploadContext uploadContext;
-        std::vector<std::function<void(VkCommandBuffer)>> nextFrameSubmits;
+
+        std::vector<PendingBufferCopy> pendingBufferCopies;
+        std::vector<PendingImageCopy> pendingImageCopies;
+        u32 lastUploadCount = 0;
+        u64 lastUploadBytes = 0;
 
     public:
         FrameData& GetCurrentFrame() {
@@ -41,10 +41,14 @@ namespace mc::details
     }
 
     std::vector<const char*> VulkanUtils::GetRequiredExtensions() {
-        uint32_t glfwExtensionCount = 0;
-        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        std::vector<const char*> extensions;
 
-        std::vector extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        // GLFW is not initialized without a window
+        if(!RendererAPI::GetState().headless) {
+            uint32_t glfwExtensionCount = 0;
+            const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if(g_enableValidationLayers)
             extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -52,6 +56,17 @@ namespace mc::details
         return extensions;
     }
 
+    std::vector<const char*> VulkanUtils::GetRequiredDeviceExtensions() {
+        std::vector<const char*> extensions(DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end());
+
+        if(RendererAPI::GetState().headless)
+            std::erase_if(extensions, [](const char* extension) {
+                return std::string_view(extension) == VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+            });
+
+        return extensions;
+    }
+
     SwapchainSupportDetails VulkanUtils::GetSwapchainSupportDetails(VkPhysicalDevice device) {
         auto& state = RendererAPI::GetState();
 
@@ -102,7 +117,8 @@ namespace mc::details
             std::vector<VkExtensionProperties> availableExtensions(extensionCount);
             vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-            std::set<std::string> requiredExtensions = {DEVICE_EXTENSIONS.begin(), DEVICE_EXTENSIONS.end()};
+            std::vector<const char*> deviceExtensions = GetRequiredDeviceExtensions();
+            std::set<std::string> requiredExtensions = {deviceExtensions.begin(), deviceExtensions.end()};
 
             for(const auto& [extensionName, specVersion] : availableExtensions)
                 requiredExtensions.erase(extensionName);
@@ -121,8 +137,10 @@ namespace mc::details
 
             u32 i = 0;
             for(const auto& queueFamily : queueFamilies) {
-                VkBool32 presentSupport = false;
-                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, state.surface, &presentSupport);
+                // Headless frames are never presented, so the graphics queue doubles as the present one
+                VkBool32 presentSupport = state.headless;
+                if(!state.headless)
+                    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, state.surface, &presentSupport);
                 
                 if(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT && presentSupport) {
                     if(indices.graphicsFamily != indices.presentFamily || indices.graphicsFamily == ~0u) {
@@ -150,13 +168,15 @@ namespace mc::details
         }
 
         // Required Swapchain Support
-        swapchain = GetSwapchainSupportDetails(device);
+        if(!state.headless) {
+            swapchain = GetSwapchainSupportDetails(device);
 
-        if(swapchain.formats.empty())
-            return -1;
+            if(swapchain.formats.empty())
+                return -1;
 
-        if(swapchain.presentModes.empty())
-            return -1;
+            if(swapchain.presentModes.empty())
+                return -1;
+        }
 
         switch(deviceProperties.deviceType) {
             case VK_PHYSICAL_DEVICE_TYPE_OTHER:
@@ -16,6 +16,8 @@ namespace mc::details
         static bool CheckValidationLayerSupport();
 
         static std::vector<const char*> GetRequiredExtensions();
+        // DEVICE_EXTENSIONS without the swapchain when rendering headless
+        static std::vector<const char*> GetRequiredDeviceExtensions();
 
         static SwapchainSupportDetails GetSwapchainSupportDetails(VkPhysicalDevice device);
 
@@ -0,0 +1,27 @@
+﻿#pragma once
+
+#include <mutex>
+
+namespace mc
+{
+    // Mutex guarded FIFO for handing work items between threads.
+    template <typename T>
+    class ConcurrentQueue
+    {
+    public:
+        void Push(T value);
+
+        bool TryPop(T& value);
+
+        // Moves every queued item into out, taking the lock only once
+        void Drain(std::vector<T>& out);
+
+        u64 GetSize() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::deque<T> m_queue;
+    };
+}
+
+#include "ConcurrentQueue.tpp"
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include "ConcurrentQueue.h"
+
+namespace mc
+{
+    template <typename T>
+    void ConcurrentQueue<T>::Push(T value) {
+        std::lock_guard lock(m_mutex);
+        m_queue.push_back(std::move(value));
+    }
+
+    template <typename T>
+    bool ConcurrentQueue<T>::TryPop(T& value) {
+        std::lock_guard lock(m_mutex);
+        if(m_queue.empty())
+            return false;
+
+        value = std::move(m_queue.front());
+        m_queue.pop_front();
+        return true;
+    }
+
+    template <typename T>
+    void ConcurrentQueue<T>::Drain(std::vector<T>& out) {
+        std::lock_guard lock(m_mutex);
+        std::ranges::move(m_queue, std::back_inserter(out));
+        m_queue.clear();
+    }
+
+    template <typename T>
+    u64 ConcurrentQueue<T>::GetSize() const {
+        std::lock_guard lock(m_mutex);
+        return m_queue.size();
+    }
+}
@@ -0,0 +1,92 @@
+﻿#include "mcpch.h"
+#include "JobSystem.h"
+
+namespace mc
+{
+    void JobSystem::Init(u32 threadCount) {
+        if(threadCount == 0)
+            threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        s_stopping = false;
+        s_workers.reserve(threadCount);
+        for(u32 i = 0; i < threadCount; i++)
+            s_workers.emplace_back(WorkerLoop);
+    }
+
+    void JobSystem::Deinit() {
+        {
+            std::lock_guard lock(s_mutex);
+            s_stopping = true;
+            s_jobs.clear();
+        }
+        s_jobAvailable.notify_all();
+
+        for(std::thread& worker : s_workers)
+            worker.join();
+        s_workers.clear();
+    }
+
+    void JobSystem::Submit(Job job) {
+        {
+            std::lock_guard lock(s_mutex);
+            s_jobs.push_back(std::move(job));
+        }
+        s_jobAvailable.notify_one();
+    }
+
+    void JobSystem::ParallelFor(u32 count, const std::function<void(u32)>& body) {
+        struct Batch
+        {
+            std::atomic<u32> next = 0;
+            std::atomic<u32> done = 0;
+        };
+
+        // Helpers that start after every index was claimed return without touching body
+        auto batch = CreateRef<Batch>();
+        auto run = [batch, count, &body] {
+            for(u32 index = batch->next++; index < count; index = batch->next++) {
+                body(index);
+                batch->done.fetch_add(1, std::memory_order_release);
+            }
+        };
+
+        u32 helpers = std::min(GetWorkerCount(), count > 0 ? count - 1 : 0);
+        for(u32 i = 0; i < helpers; i++)
+            Submit(run);
+
+        run();
+
+        while(batch->done.load(std::memory_order_acquire) < count)
+            std::this_thread::yield();
+    }
+
+    void JobSystem::Wait() {
+        std::unique_lock lock(s_mutex);
+        s_idle.wait(lock, [] { return s_jobs.empty() && s_runningJobs == 0; });
+    }
+
+    void JobSystem::WorkerLoop() {
+        while(true) {
+            Job job;
+            {
+                std::unique_lock lock(s_mutex);
+                s_jobAvailable.wait(lock, [] { return s_stopping || !s_jobs.empty(); });
+                if(s_stopping)
+                    return;
+
+                job = std::move(s_jobs.front());
+                s_jobs.pop_front();
+                s_runningJobs++;
+            }
+
+            job();
+
+            {
+                std::lock_guard lock(s_mutex);
+                s_runningJobs--;
+                if(s_jobs.empty() && s_runningJobs == 0)
+                    s_idle.notify_all();
+            }
+        }
+    }
+}
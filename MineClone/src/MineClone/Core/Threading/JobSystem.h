@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace mc
+{
+    // Fixed pool of worker threads consuming a shared FIFO of jobs.
+    class JobSystem
+    {
+    public:
+        using Job = std::function<void()>;
+
+    public:
+        // threadCount of 0 uses one worker per hardware thread, leaving one for the main thread
+        static void Init(u32 threadCount = 0);
+        // Drops jobs that have not started yet and joins the workers once the running ones finish
+        static void Deinit();
+
+        static void Submit(Job job);
+
+        // Runs body for every index of [0, count) on the workers and the calling thread and returns once all finished.
+        // The caller claims indices itself, so it never waits on jobs queued ahead of the helpers.
+        static void ParallelFor(u32 count, const std::function<void(u32)>& body);
+
+        // Blocks until the queue is empty and no job is running
+        static void Wait();
+
+    public:
+        static u32 GetWorkerCount() { return (u32)s_workers.size(); }
+
+    private:
+        static void WorkerLoop();
+
+    private:
+        inline static std::vector<std::thread> s_workers;
+
+        inline static std::mutex s_mutex;
+        inline static std::condition_variable s_jobAvailable;
+        inline static std::condition_variable s_idle;
+        inline static std::deque<Job> s_jobs;
+        inline static u32 s_runningJobs = 0;
+        inline static bool s_stopping = false;
+    };
+}
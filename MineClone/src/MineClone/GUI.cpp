@@ -61,6 +61,7 @@ namespace mc
 			.PhysicalDevice = state.physicalDevice,
 			.Device = state.device,
 			.Queue = state.graphicsQueue,
+			.PipelineCache = state.pipelineCache,
 			.DescriptorPool = imguiPool,
 			.MinImageCount = 3,
 			.ImageCount = 3,
@@ -98,7 +99,6 @@ namespace mc
     void GUI::EndFrame() {
     	ImGui::Render();
 
-    	FrameData& currentFrame = RendererAPI::GetState().GetCurrentFrame();
-    	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), currentFrame.commandBuffer);
+    	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), RendererAPI::GetRecordingCommandBuffer());
     }
 }
@@ -1,17 +1,18 @@
 ﻿#include "mcpch.h"
 #include "Block.h"
 
+#include "BlockTable.h"
 #include "MineClone/Config.h"
 #include "MineClone/Game/Utils/Facing.h"
 
 namespace mc
 {
-    const Block& Block::AIR = REGISTRY.Register(new Block("air", -1, true));
-    const Block& Block::STONE = REGISTRY.Register(new Block("stone", 1));
-    const Block& Block::GRASS_BLOCK = REGISTRY.Register(new Block("grass_block", {{0, 2, 3, 3, 3, 3}}));
-    const Block& Block::DIRT = REGISTRY.Register(new Block("dirt", 2));
-    const Block& Block::SAND = REGISTRY.Register(new Block("sand", 18));
-    const Block& Block::OAK_LOG = REGISTRY.Register(new Block("oak_log", {{21, 21, 20, 20, 20, 20}}));
+    const Block& Block::AIR = Register(new Block("air", -1, true));
+    const Block& Block::STONE = Register(new Block("stone", 1));
+    const Block& Block::GRASS_BLOCK = Register(new Block("grass_block", {{0, 2, 3, 3, 3, 3}}));
+    const Block& Block::DIRT = Register(new Block("dirt", 2));
+    const Block& Block::SAND = Register(new Block("sand", 18));
+    const Block& Block::OAK_LOG = Register(new Block("oak_log", {{21, 21, 20, 20, 20, 20}}));
 
     Block::Block(const std::string& name, u64 textureIndex, bool transparent)
         : Block(name, std::array<u64, 6>{{textureIndex, textureIndex, textureIndex, textureIndex, textureIndex, textureIndex}}, transparent) {}
@@ -20,8 +21,12 @@ namespace mc
         : RegistryEntry(name), m_textureIndexes(textureIndexes), m_transparent(transparent) {}
 
     float4 Block::GetTextureUVs(const Facing& facing) const {
-        u64 x = m_textureIndexes[facing.index] % Config::ATLAS_SIZE.x;
-        u64 y = Config::ATLAS_SIZE.y - m_textureIndexes[facing.index] / Config::ATLAS_SIZE.x;
+        return GetAtlasUVs(m_textureIndexes[facing.index]);
+    }
+
+    float4 Block::GetAtlasUVs(u64 textureIndex) {
+        u64 x = textureIndex % Config::ATLAS_SIZE.x;
+        u64 y = Config::ATLAS_SIZE.y - textureIndex / Config::ATLAS_SIZE.x;
         
         return {
             (f32)x * Config::ATLAS_ELEMENT_SIZE.x,
@@ -30,4 +35,10 @@ namespace mc
             (f32)y * Config::ATLAS_ELEMENT_SIZE.y,
         };
     }
+
+    const Block& Block::Register(Block* block) {
+        const Block& registered = REGISTRY.Register(block);
+        BlockTable::Add(registered);
+        return registered;
+    }
 }
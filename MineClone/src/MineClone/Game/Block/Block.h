@@ -27,16 +27,27 @@ namespace mc
         Block(const std::string& name, std::array<u64, 6> textureIndexes, bool transparent = false);
 
     public:
-        virtual void Tick(World& world, int3 pos, BlockState& blockState) const {}
+        // Only called for blocks that set m_ticking
+        virtual void Tick(World& world, int3 pos, const BlockState& blockState) const {}
 
     public:
         float4 GetTextureUVs(const Facing& facing) const;
+        u64 GetTextureIndex(u32 facing) const { return m_textureIndexes[facing]; }
+
+        static float4 GetAtlasUVs(u64 textureIndex);
         
     public:
         bool IsTransparent() const { return m_transparent; }
+        bool IsTicking() const { return m_ticking; }
+
+    private:
+        static const Block& Register(Block* block);
         
     private:
         std::array<u64, 6> m_textureIndexes;
         bool m_transparent;
+
+    protected:
+        bool m_ticking = false;
     };
 }
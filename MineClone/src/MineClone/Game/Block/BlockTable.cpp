@@ -0,0 +1,27 @@
+﻿#include "mcpch.h"
+#include "BlockTable.h"
+
+#include "Block.h"
+
+namespace mc
+{
+    void BlockTable::Add(const Block& block) {
+        u16 index = block.GetIndex();
+        
+        if(s_transparent.size() <= index) {
+            s_transparent.resize(index + 1ull);
+            s_ticking.resize(index + 1ull);
+            s_textureIndexes.resize((index + 1ull) * FACES);
+        }
+
+        s_transparent[index] = block.IsTransparent();
+        s_ticking[index] = block.IsTicking();
+        // Runs during static initialization, so Facing::FACINGS can't be relied on here
+        for(u32 facing = 0; facing < FACES; facing++)
+            s_textureIndexes[index * FACES + facing] = (u16)block.GetTextureIndex(facing);
+    }
+
+    float4 BlockTable::GetTextureUVs(u16 blockIndex, const Facing& facing) {
+        return Block::GetAtlasUVs(GetTextureIndex(blockIndex, facing.index));
+    }
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+namespace mc
+{
+    class Block;
+    class Facing;
+
+    // Structure-of-arrays copy of hot block properties, indexed by the dense block index.
+    // Lets hot loops test a flag without touching the Block object itself.
+    class BlockTable
+    {
+    public:
+        static void Add(const Block& block);
+
+    public:
+        static bool IsTransparent(u16 blockIndex) { return s_transparent[blockIndex]; }
+        static bool IsTicking(u16 blockIndex) { return s_ticking[blockIndex]; }
+        
+        static u16 GetTextureIndex(u16 blockIndex, u32 facing) { return s_textureIndexes[blockIndex * FACES + facing]; }
+        static float4 GetTextureUVs(u16 blockIndex, const Facing& facing);
+
+    private:
+        static constexpr u64 FACES = 6;
+        
+        inline static std::vector<u8> s_transparent{};
+        inline static std::vector<u8> s_ticking{};
+        inline static std::vector<u16> s_textureIndexes{};
+    };
+}
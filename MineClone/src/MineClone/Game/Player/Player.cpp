@@ -11,14 +11,12 @@ namespace mc
 {
     static std::vector<const Block*> g_blocksList;
     
-    Player::Player(World& world)
-        : m_world(world), m_camera(60.f, 1280, 720) {
+    Player::Player(World& world, Ref<Material> blockIndicatorMaterial)
+        : m_world(world), m_camera(60.f, 1280, 720), m_blockIndicatorMat(std::move(blockIndicatorMaterial)) {
         
         m_camera.SetPosition({0, 100, 30});
         m_camera.SetRotation({-30, 0});
 
-        m_selectedBlockMesh.SetIndices(std::span(Config::INDICES.data(), Config::INDICES.size()));
-
         {
             std::vector<Vertex3D> vertices;
             vertices.append_range(std::span(Config::VERTICES.front().data(), 6ull * 4ull));
@@ -34,12 +32,11 @@ namespace mc
 
             m_blockIndicatorTexture = RendererAPI::LoadTexture("assets/block indicator.png", VK_FILTER_NEAREST);
 
-            m_blockIndicatorMat = Material::Create("Block Indicator", Vertex3D::GetDescription());
             m_blockIndicatorMat->SetTexture(m_blockIndicatorTexture);
         }
 
         if(g_blocksList.empty()) {
-            g_blocksList.append_range(Block::REGISTRY | std::views::values);
+            g_blocksList.append_range(Block::REGISTRY);
             g_blocksList.erase(std::ranges::remove(g_blocksList, &Block::AIR).begin());
         }
         SelectSlot(0);
@@ -126,26 +123,16 @@ namespace mc
         m_selectedBlockIndex = index;
         const Block* block = g_blocksList[m_selectedBlockIndex];
             
-        std::vector<Vertex3D> vertices;
+        // Rendered with the chunk material, so it uses the chunk vertex format
+        std::vector<ChunkVertex> vertices;
         vertices.reserve(24);
             
         for(const Facing& facing : Facing::FACINGS) {
-            auto face = Config::VERTICES[facing];
-            float4 uvRect = block->GetTextureUVs(facing);
-            std::array<float2, 4> uvs = {{
-                uvRect.xy,
-                uvRect.zy,
-                uvRect.xw,
-                uvRect.zw
-            }};
-
-            int vIndex = 0;
-            for(Vertex3D v : face) {
-                v.uv = uvs[vIndex++];
-                vertices.push_back(v);
-            }
+            u32 tile = (u32)block->GetTextureIndex(facing.index);
+            for(u32 corner = 0; corner < 4; corner++)
+                vertices.push_back(ChunkVertex::Pack(int3(Config::VERTICES[facing][corner].pos), facing.index, corner, tile));
         }
             
-        m_selectedBlockMesh.SetVertices(std::span(vertices));
+        m_selectedBlockMesh.SetQuads(std::span(vertices));
     }
 }
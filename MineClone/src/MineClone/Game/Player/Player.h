@@ -7,7 +7,7 @@ namespace mc
     class Player
     {
     public:
-        explicit Player(World& world);
+        Player(World& world, Ref<Material> blockIndicatorMaterial);
         ~Player();
 
         Player(const Player&) = delete;
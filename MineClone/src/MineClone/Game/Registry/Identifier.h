@@ -9,3 +9,12 @@ namespace mc
         std::strong_ordering operator<=>(const Identifier& identifier) const = default;
     };
 }
+
+// ReSharper disable once CppInconsistentNaming
+template <>
+struct std::hash<mc::Identifier>
+{
+    size_t operator()(const mc::Identifier& identifier) const noexcept {
+        return std::hash<std::string>{}(identifier.name);
+    }
+};
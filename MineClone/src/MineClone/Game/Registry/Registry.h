@@ -19,16 +19,21 @@ namespace mc
         constexpr const T& Register(T* entry);
 
         constexpr const T& GetByID(Identifier id);
+        constexpr const T& GetByIndex(u16 index) const { return *m_entries[index]; }
+
+        constexpr u16 GetSize() const { return (u16)m_entries.size(); }
 
     public:
-        constexpr auto begin() { return m_registry.begin(); }
-        constexpr auto end()  { return m_registry.end(); }
+        constexpr auto begin() { return m_entries.begin(); }
+        constexpr auto end()  { return m_entries.end(); }
 
-        constexpr auto begin() const { return m_registry.begin(); }
-        constexpr auto end() const { return m_registry.end(); }
+        constexpr auto begin() const { return m_entries.begin(); }
+        constexpr auto end() const { return m_entries.end(); }
         
     private:
-        std::map<Identifier, T*> m_registry{};
+        // Entries are indexed by their dense runtime index, assigned in registration order
+        std::vector<T*> m_entries{};
+        std::unordered_map<Identifier, u16> m_indices{};
     };
 }
 
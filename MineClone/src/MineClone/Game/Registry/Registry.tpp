@@ -5,13 +5,18 @@ namespace mc
 {
     template <typename T>
     constexpr const T& Registry<T>::Register(T* entry) {
-        m_registry.emplace(entry->m_identifier, entry);
+        if(m_entries.size() > std::numeric_limits<u16>::max())
+            throw std::runtime_error("Registry is full!");
+
+        entry->m_index = (u16)m_entries.size();
+        m_indices.emplace(entry->m_identifier, entry->m_index);
+        m_entries.push_back(entry);
 
         return *entry;
     }
 
     template <typename T>
     constexpr const T& Registry<T>::GetByID(Identifier id) {
-        return *m_registry.at(id);
+        return *m_entries[m_indices.at(id)];
     }
 }
@@ -24,6 +24,7 @@ namespace mc
     public:
         constexpr Identifier GetId() const;
         constexpr const std::string& GetName() const;
+        constexpr u16 GetIndex() const { return m_index; }
         
         friend std::strong_ordering operator<=>(const RegistryEntry& entry, const RegistryEntry& otherEntry) {
             return &entry <=> &otherEntry;
@@ -36,6 +37,7 @@ namespace mc
 
     private:
         Identifier m_identifier;
+        u16 m_index = 0;
 
         friend class Registry<T>;
     };
@@ -21,7 +21,7 @@ namespace mc
     }
 
     void Biome::Init(i32 seed) {
-        for(Biome* biome : REGISTRY | std::views::values)
+        for(Biome* biome : REGISTRY)
             biome->m_heightGenerator.SetSeed(seed);
     }
 
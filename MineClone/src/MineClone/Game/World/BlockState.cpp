@@ -4,11 +4,11 @@
 namespace mc
 {
     BlockState::BlockState()
-        : m_block(&Block::AIR) {}
+        : m_blockIndex(Block::AIR.GetIndex()) {}
 
     BlockState::BlockState(Identifier blockId)
-        : m_block(&Block::REGISTRY.GetByID(blockId)) {}
+        : m_blockIndex(Block::REGISTRY.GetByID(blockId).GetIndex()) {}
 
     BlockState::BlockState(const Block& block)
-        : m_block(&block) {}
+        : m_blockIndex(block.GetIndex()) {}
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "MineClone/Game/Block/Block.h"
+#include "MineClone/Game/Block/BlockTable.h"
 
 namespace mc
 {
@@ -18,10 +19,17 @@ namespace mc
         BlockState& operator=(BlockState&& other) noexcept = default;
 
     public:
-        const Block& GetBlock() const { return *m_block; }
+        const Block& GetBlock() const { return Block::REGISTRY.GetByIndex(m_blockIndex); }
+        u16 GetBlockIndex() const { return m_blockIndex; }
+
+        bool IsAir() const { return m_blockIndex == Block::AIR.GetIndex(); }
+        bool IsTransparent() const { return BlockTable::IsTransparent(m_blockIndex); }
+        bool IsTicking() const { return BlockTable::IsTicking(m_blockIndex); }
+
+        bool operator==(const BlockState& other) const = default;
 
     private:
-        const Block* m_block;
+        u16 m_blockIndex;
 
         //todo: nbt
     };
@@ -0,0 +1,107 @@
+﻿#include "mcpch.h"
+#include "BlockStorage.h"
+
+namespace mc
+{
+    BlockStorage::BlockStorage(u64 size, const BlockState& initial)
+        : m_size(size), m_palette{initial} {}
+
+    void BlockStorage::Set(u64 index, const BlockState& blockState) {
+        u32 current = GetPaletteIndex(index);
+        if(m_palette[current] == blockState)
+            return;
+
+        SetPaletteIndex(index, FindOrAddPaletteEntry(blockState));
+    }
+
+    void BlockStorage::Compact() {
+        if(IsUniform())
+            return;
+
+        std::vector<u32> remap(m_palette.size(), ~0u);
+        std::vector<BlockState> palette;
+
+        for(u64 i = 0; i < m_size; i++) {
+            u32 paletteIndex = GetPaletteIndex(i);
+            if(remap[paletteIndex] == ~0u) {
+                remap[paletteIndex] = (u32)palette.size();
+                palette.push_back(m_palette[paletteIndex]);
+            }
+        }
+
+        if(palette.size() == m_palette.size())
+            return;
+
+        BlockStorage compacted(m_size, palette.front());
+        if(palette.size() > 1) {
+            compacted.m_bitsPerEntry = GetBitsForPaletteSize(palette.size());
+            compacted.m_palette = std::move(palette);
+            compacted.m_data.assign(GetWordCount(m_size, compacted.m_bitsPerEntry), 0);
+
+            for(u64 i = 0; i < m_size; i++)
+                compacted.SetPaletteIndex(i, remap[GetPaletteIndex(i)]);
+        }
+
+        *this = std::move(compacted);
+    }
+
+    u64 BlockStorage::GetMemoryUsage() const {
+        return sizeof(BlockStorage) + m_palette.capacity() * sizeof(BlockState) + m_data.capacity() * sizeof(u64);
+    }
+
+    u32 BlockStorage::GetPaletteIndex(u64 index) const {
+        if(IsUniform())
+            return 0;
+
+        u64 bitIndex = index * m_bitsPerEntry;
+        u64 mask = (1ull << m_bitsPerEntry) - 1;
+        return (u32)((m_data[bitIndex / WORD_BITS] >> (bitIndex % WORD_BITS)) & mask);
+    }
+
+    void BlockStorage::SetPaletteIndex(u64 index, u32 paletteIndex) {
+        u64 bitIndex = index * m_bitsPerEntry;
+        u64 mask = (1ull << m_bitsPerEntry) - 1;
+        u64 shift = bitIndex % WORD_BITS;
+
+        u64& word = m_data[bitIndex / WORD_BITS];
+        word = (word & ~(mask << shift)) | ((u64)paletteIndex & mask) << shift;
+    }
+
+    u32 BlockStorage::FindOrAddPaletteEntry(const BlockState& blockState) {
+        for(u32 i = 0; i < (u32)m_palette.size(); i++)
+            if(m_palette[i] == blockState)
+                return i;
+
+        m_palette.push_back(blockState);
+
+        if(m_palette.size() > 1ull << m_bitsPerEntry)
+            Repack(GetBitsForPaletteSize(m_palette.size()));
+
+        return (u32)m_palette.size() - 1;
+    }
+
+    void BlockStorage::Repack(u32 bitsPerEntry) {
+        BlockStorage old = std::move(*this);
+
+        m_size = old.m_size;
+        m_bitsPerEntry = bitsPerEntry;
+        m_palette = std::move(old.m_palette);
+        m_data.assign(GetWordCount(m_size, m_bitsPerEntry), 0);
+
+        for(u64 i = 0; i < m_size; i++)
+            SetPaletteIndex(i, old.GetPaletteIndex(i));
+    }
+
+    u32 BlockStorage::GetBitsForPaletteSize(u64 paletteSize) {
+        if(paletteSize <= 1ull << 1)
+            return 1;
+        if(paletteSize <= 1ull << 4)
+            return 4;
+        if(paletteSize <= 1ull << 8)
+            return 8;
+        if(paletteSize <= 1ull << 16)
+            return 16;
+
+        throw std::runtime_error("Block storage palette exceeded 65536 entries!");
+    }
+}
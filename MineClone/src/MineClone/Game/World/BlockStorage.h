@@ -0,0 +1,57 @@
+﻿#pragma once
+#include "BlockState.h"
+
+namespace mc
+{
+    // Palette compressed block state container.
+    // Stores every distinct block state once in a palette and keeps only bit-packed palette indices per block.
+    // Index width grows 1 -> 4 -> 8 -> 16 bits as the palette fills up, so entries never straddle 64-bit words.
+    // A storage holding a single block state is uniform: it keeps only the palette and allocates no index data.
+    class BlockStorage
+    {
+    public:
+        explicit BlockStorage(u64 size, const BlockState& initial = {});
+        ~BlockStorage() = default;
+
+        BlockStorage(const BlockStorage& other) = default;
+        BlockStorage(BlockStorage&& other) noexcept = default;
+        BlockStorage& operator=(const BlockStorage& other) = default;
+        BlockStorage& operator=(BlockStorage&& other) noexcept = default;
+
+    public:
+        // Returned reference points into the palette and stays valid until the palette grows.
+        const BlockState& Get(u64 index) const { return m_palette[GetPaletteIndex(index)]; }
+        void Set(u64 index, const BlockState& blockState);
+
+        // Drops unused palette entries and shrinks the index width, collapsing back to uniform when possible.
+        void Compact();
+
+    public:
+        bool IsUniform() const { return m_bitsPerEntry == 0; }
+
+        u64 GetSize() const { return m_size; }
+        u32 GetBitsPerEntry() const { return m_bitsPerEntry; }
+        const std::vector<BlockState>& GetPalette() const { return m_palette; }
+
+        u64 GetMemoryUsage() const;
+
+    private:
+        u32 GetPaletteIndex(u64 index) const;
+        void SetPaletteIndex(u64 index, u32 paletteIndex);
+
+        u32 FindOrAddPaletteEntry(const BlockState& blockState);
+        void Repack(u32 bitsPerEntry);
+
+        static u32 GetBitsForPaletteSize(u64 paletteSize);
+        static u64 GetWordCount(u64 size, u32 bitsPerEntry) { return (size * bitsPerEntry + WORD_BITS - 1) / WORD_BITS; }
+
+    private:
+        static constexpr u32 WORD_BITS = 64;
+
+        u64 m_size;
+        u32 m_bitsPerEntry = 0;
+
+        std::vector<BlockState> m_palette;
+        std::vector<u64> m_data;
+    };
+}
@@ -1,98 +1,103 @@
 ﻿#include "mcpch.h"
 #include "Chunk.h"
 
-#include <glm/ext/matrix_transform.hpp>
-
 #include "World.h"
+#include "ChunkMesher.h"
+#include "MineClone/Core/Renderer/RendererAPI.h"
 #include "MineClone/Game/Utils/Facing.h"
 
 namespace mc
 {
     Chunk::Chunk(int3 id, ChunkColumn& chunkColumn)
-        : m_id(id), m_chunkColumn(chunkColumn), m_transform(translate(Mat4{1}, float3(id) * float3(Config::CHUNK_SIZE))) {}
+        : m_id(id), m_chunkColumn(chunkColumn), m_origin(float3(id * Config::CHUNK_SIZE)) {}
+
+    Chunk::~Chunk() {
+        GeometryArena::Free(m_geometry);
+    }
 
     void Chunk::Tick(World& world) {
+        if(!IsGenerated() || std::ranges::none_of(m_blockStates.GetPalette(), &BlockState::IsTicking))
+            return;
+
+        // Every ticking block of the chunk ticks. The loops used to never reset pos.y and pos.x, which ticked only the first row.
         int3 pos = {0, 0, 0};
-        for(; pos.z < Config::CHUNK_SIZE.z; pos.z++)
-            for(; pos.y < Config::CHUNK_SIZE.y; pos.y++)
-                for(; pos.x < Config::CHUNK_SIZE.x; pos.x++)
+        for(pos.z = 0; pos.z < Config::CHUNK_SIZE.z; pos.z++)
+            for(pos.y = 0; pos.y < Config::CHUNK_SIZE.y; pos.y++)
+                for(pos.x = 0; pos.x < Config::CHUNK_SIZE.x; pos.x++)
                 {
-                    BlockState& blockState = m_blockStates[ToIndex(pos)];
-                    blockState.GetBlock().Tick(world, pos, blockState);
+                    const BlockState& blockState = m_blockStates.Get(ToIndex(pos));
+                    if(blockState.IsTicking())
+                        blockState.GetBlock().Tick(world, pos, blockState);
                 }
     }
     
     void Chunk::UpdateMesh() {
-        std::vector<Vertex3D> vertices;
-        std::vector<u32> indices;
-
-        for(u64 z = 0; z < Config::CHUNK_SIZE.z; z++)
-            for(u64 y = 0; y < Config::CHUNK_SIZE.y; y++)
-                for(u64 x = 0; x < Config::CHUNK_SIZE.x; x++) {
-                    int3 chunkPos = {x, y, z};
-                    BlockState& current = m_blockStates[ToIndex(chunkPos)];
-
-                    if(current.GetBlock().IsTransparent())
-                        continue;
-                    
-                    for(u64 i = 0; i < Facing::FACINGS.size(); i++) {
-                        int3 neighbourPos = chunkPos + Facing::FACINGS[i].directionVec;
-                        
-                        BlockState* neighbour = nullptr;
-                        if(neighbourPos.x < 0 || neighbourPos.x >= Config::CHUNK_SIZE.x ||
-                           neighbourPos.y < 0 || neighbourPos.y >= Config::CHUNK_SIZE.y ||
-                           neighbourPos.z < 0 || neighbourPos.z >= Config::CHUNK_SIZE.z)
-                            neighbour = m_chunkColumn.GetBlockState(m_id * Config::CHUNK_SIZE + neighbourPos);
-                        else
-                            neighbour = &m_blockStates[ToIndex(neighbourPos)];
-
-                        if(neighbour && neighbour->GetBlock().IsTransparent() ||
-                           !neighbour && chunkPos.y == Config::CHUNK_SIZE.y - 1) {
-                            auto face = Config::VERTICES[i];
-                            u32 firstVertexIndex = (u32)vertices.size();
-
-                            float4 uvRect = current.GetBlock().GetTextureUVs(Facing::FACINGS[i]);
-                            std::array<float2, 4> uvs = {{
-                                uvRect.xy,
-                                uvRect.zy,
-                                uvRect.xw,
-                                uvRect.zw
-                            }};
-
-                            int vIndex = 0;
-                            for(Vertex3D v : face) {
-                                v.pos += chunkPos;
-                                v.uv = uvs[vIndex++];
-                                vertices.push_back(v);
-                            }
-                            
-                            indices.push_back(firstVertexIndex + 0);
-                            indices.push_back(firstVertexIndex + 3);
-                            indices.push_back(firstVertexIndex + 1);
-                            indices.push_back(firstVertexIndex + 0);
-                            indices.push_back(firstVertexIndex + 2);
-                            indices.push_back(firstVertexIndex + 3);
-                        }                            
-                    }
-                }
+        ChunkMesher::QueueRemesh(*this);
+    }
+
+    void Chunk::Render(u8 facingMask) const {
+        if(!IsRenderable())
+            return;
 
-        m_mesh.SetIndices(indices);
-        m_mesh.SetVertices(std::span(vertices));
+        ForEachQuadRange(facingMask, [this](u32 firstQuad, u32 quadCount) {
+            if(IsInArena())
+                RendererAPI::DrawChunkQuads(m_origin, GeometryArena::GetBuffer(), quadCount, m_geometry.firstQuad + firstQuad);
+            else
+                m_mesh.RenderChunkQuads(m_origin, firstQuad, quadCount);
+        });
     }
 
-    void Chunk::Render() const {
-        m_mesh.Render(m_transform);
+    void Chunk::AddDraws(u8 facingMask, std::vector<QuadDraw>& draws) const {
+        ForEachQuadRange(facingMask, [&](u32 firstQuad, u32 quadCount) {
+            draws.push_back({m_geometry.firstQuad + firstQuad, quadCount, m_origin});
+        });
     }
 
-    BlockState* Chunk::GetBlockState(int3 blockPos) {        
-        int3 chunkID = ToChunkID(blockPos);
+    u32 Chunk::GetDrawCount(u8 facingMask) const {
+        u32 drawCount = 0;
+        ForEachQuadRange(facingMask, [&](u32, u32) { drawCount++; });
+        return drawCount;
+    }
 
-        if(chunkID != m_id)
-            return m_chunkColumn.GetBlockState(blockPos);
+    void Chunk::ForEachQuadRange(u8 facingMask, const std::function<void(u32 firstQuad, u32 quadCount)>& function) const {
+        for(u32 first = 0; first < 6; first++) {
+            if(!(facingMask >> first & 1))
+                continue;
 
-        int3 chunkPos = ToChunkPos(blockPos);
-        u64 index = ToIndex(chunkPos);
-        return &m_blockStates[index];
+            u32 last = first;
+            while(last + 1 < 6 && facingMask >> (last + 1) & 1)
+                last++;
+
+            u32 firstQuad = m_facingQuadOffsets[first];
+            u32 quadCount = m_facingQuadOffsets[last + 1] - firstQuad;
+            if(quadCount > 0)
+                function(firstQuad, quadCount);
+
+            first = last;
+        }
+    }
+
+    u8 Chunk::GetFacingMask(float3 cameraPosition) const {
+        float3 min = float3(m_id * Config::CHUNK_SIZE);
+        float3 max = min + float3(Config::CHUNK_SIZE);
+
+        // Faces pointing along +axis lie on planes in (min, max], the ones along -axis in [min, max)
+        u8 mask = 0;
+        mask |= (cameraPosition.y > min.y) << Facing::UP.index;
+        mask |= (cameraPosition.y < max.y) << Facing::DOWN.index;
+        mask |= (cameraPosition.z > min.z) << Facing::NORTH.index;
+        mask |= (cameraPosition.z < max.z) << Facing::SOUTH.index;
+        mask |= (cameraPosition.x > min.x) << Facing::EAST.index;
+        mask |= (cameraPosition.x < max.x) << Facing::WEST.index;
+        return mask;
+    }
+
+    u32 Chunk::GetQuadCount(u8 facingMask) const {
+        u32 quadCount = 0;
+        for(u32 i = 0; i < 6; i++)
+            if(facingMask >> i & 1)
+                quadCount += m_facingQuadOffsets[i + 1] - m_facingQuadOffsets[i];
+        return quadCount;
     }
 
     const BlockState* Chunk::GetBlockState(int3 blockPos) const {        
@@ -103,7 +108,7 @@ namespace mc
 
         int3 chunkPos = ToChunkPos(blockPos);
         u64 index = ToIndex(chunkPos);
-        return &m_blockStates[index];
+        return &m_blockStates.Get(index);
     }
 
     void Chunk::SetBlockState(int3 blockPos, const BlockState& blockState) {
@@ -115,7 +120,7 @@ namespace mc
         }
 
         int3 chunkPos = ToChunkPos(blockPos);
-        m_blockStates[ToIndex(chunkPos)] = blockState;
+        m_blockStates.Set(ToIndex(chunkPos), blockState);
 
         UpdateMesh();
 
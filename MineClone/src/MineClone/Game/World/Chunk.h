@@ -1,7 +1,12 @@
 ﻿#pragma once
 #include "BlockState.h"
+#include "BlockStorage.h"
+#include "ChunkOccluder.h"
+#include "ChunkPool.h"
+#include "ChunkVisibility.h"
 #include "IBlockStateProvider.h"
 #include "MineClone/Config.h"
+#include "MineClone/Core/Renderer/GeometryArena.h"
 #include "MineClone/Core/Renderer/Mesh.h"
 
 namespace mc
@@ -11,44 +16,103 @@ namespace mc
 
 namespace mc
 {
+    // Owned by the main thread, a chunk is only touched by a worker while Generating.
+    enum class ChunkState : u8
+    {
+        Queued,
+        Generating,
+        Generated,
+    };
+
     class Chunk final : public IBlockStateProvider
     {
     public:
         explicit Chunk(int3 id, ChunkColumn& chunkColumn);
-        virtual ~Chunk() = default;
+        virtual ~Chunk();
 
         Chunk(const Chunk& other) = delete;
         Chunk(Chunk&& other) noexcept = delete;
         Chunk& operator=(const Chunk& other) = delete;
         Chunk& operator=(Chunk&& other) noexcept = delete;
 
+        // Chunk storage is recycled through the ChunkPool slab
+        static void* operator new(u64 size) { return ChunkPool::Allocate(size); }
+        static void operator delete(void* ptr) { ChunkPool::Free(ptr); }
+
     public:
         void Tick(World& world);
 
+        // Queues an asynchronous remesh, see ChunkMesher
         void UpdateMesh();        
-        void Render() const;
+        // Draws the quads of the facings set in facingMask, merging neighbouring facings into one draw
+        void Render(u8 facingMask = ALL_FACINGS) const;
+        // Appends the quad ranges Render would draw for a mesh living in the GeometryArena
+        void AddDraws(u8 facingMask, std::vector<QuadDraw>& draws) const;
 
     public:
         int3 GetID() const { return m_id; }
+
+        ChunkState GetState() const { return m_state; }
+        bool IsGenerated() const { return m_state == ChunkState::Generated; }
+        bool IsRenderable() const { return IsGenerated() && !IsEmpty() && GetQuadCount() > 0; }
+        // The mesh lives in the GeometryArena, otherwise in its own vertex buffer
+        bool IsInArena() const { return m_geometry.IsValid(); }
+        const ChunkVisibility& GetVisibility() const { return m_visibility; }
+        const ChunkOccluder& GetOccluder() const { return m_occluder; }
+
+        // Facings whose faces can point towards a camera at cameraPosition, faces of the others are all back facing
+        u8 GetFacingMask(float3 cameraPosition) const;
+        u32 GetQuadCount(u8 facingMask = ALL_FACINGS) const;
+        // Draw calls Render issues for facingMask
+        u32 GetDrawCount(u8 facingMask = ALL_FACINGS) const;
+
+        // Uniform chunks hold a single block state and have no backing index array.
+        bool IsUniform() const { return m_blockStates.IsUniform(); }
+        bool IsEmpty() const { return IsUniform() && m_blockStates.Get(0).IsTransparent(); }
  
-        BlockState* GetBlockState(int3 blockPos) override;
         const BlockState* GetBlockState(int3 blockPos) const override;
 
         void SetBlockState(int3 blockPos, const BlockState& blockState) override;
 
+        u64 GetMemoryUsage() const { return sizeof(Chunk) + m_blockStates.GetMemoryUsage() - sizeof(BlockStorage); }
+
+    public:
+        static constexpr u64 VOLUME = (u64)Config::CHUNK_SIZE.x * Config::CHUNK_SIZE.y * Config::CHUNK_SIZE.z;
+        static constexpr u8 ALL_FACINGS = (1 << 6) - 1;
+
     private:
         static u64 ToIndex(int3 chunkPos);
+
+        // Calls function for every run of neighbouring facings in facingMask, merged into one quad range
+        void ForEachQuadRange(u8 facingMask, const std::function<void(u32 firstQuad, u32 quadCount)>& function) const;
             
     private:
         int3 m_id;
         ChunkColumn& m_chunkColumn;
+        ChunkState m_state = ChunkState::Queued;
+
+        bool m_remeshQueued = false;
+        // Revision of the last dispatched remesh, older results are dropped
+        u64 m_meshRevision = 0;
         
-        std::array<BlockState, (u64)(Config::CHUNK_SIZE.x * Config::CHUNK_SIZE.y * Config::CHUNK_SIZE.z)> m_blockStates;
+        BlockStorage m_blockStates{VOLUME};
         
+        // Fallback for meshes the GeometryArena has no room for
         Mesh m_mesh;
-        Mat4 m_transform{};
+        GeometryAllocation m_geometry;
+        float3 m_origin{};
+        // Mesh quads are grouped by Facing, see ChunkMesher::MeshData
+        std::array<u32, 7> m_facingQuadOffsets{};
+
+        // Computed together with the mesh, open until then
+        ChunkVisibility m_visibility = ChunkVisibility::All();
+        // Computed together with the mesh, occludes nothing until then
+        ChunkOccluder m_occluder;
 
         friend class ChunkManager;
         friend class ChunkGenerator;
+        friend class ChunkMesher;
+        friend class ChunkOccluder;
+        friend class ChunkVisibility;
     };
 }
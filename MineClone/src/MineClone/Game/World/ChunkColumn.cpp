@@ -20,10 +20,10 @@ namespace mc
                 chunk->UpdateMesh();
     }
 
-    void ChunkColumn::Render() {
-        for(Scope<Chunk>& chunk : m_chunks)
-            if(chunk)
-                chunk->Render();
+    bool ChunkColumn::HasChunksInFlight() const {
+        return std::ranges::any_of(m_chunks, [](const Scope<Chunk>& chunk) {
+            return chunk && chunk->GetState() == ChunkState::Generating;
+        });
     }
 
     Chunk* ChunkColumn::GetChunk(int3 chunkID) {
@@ -46,25 +46,6 @@ namespace mc
         return m_chunks.at(chunkID.y).get();
     }
 
-    BlockState* ChunkColumn::GetBlockState(int3 blockPos) {
-        if(blockPos.y >= (i32)(Config::WORLD_SIZE.y * Config::CHUNK_SIZE.y))
-            return nullptr;
-
-        if(blockPos.y < 0)
-            return nullptr;        
-        
-        int3 chunkID = ToChunkID(blockPos);
-        int2 columnID = int2(chunkID.xz);
-        
-        if(columnID != m_id)
-            return m_world.GetBlockState(blockPos);
-
-        if(const Scope<Chunk>& chunk = m_chunks[chunkID.y])
-            return chunk->GetBlockState(blockPos);
-
-        return nullptr;
-    }
-
     const BlockState* ChunkColumn::GetBlockState(int3 blockPos) const {
         if(blockPos.y >= (i32)(Config::WORLD_SIZE.y * Config::CHUNK_SIZE.y))
             return nullptr;
@@ -78,8 +59,14 @@ namespace mc
         if(columnID != m_id)
             return m_world.GetBlockState(blockPos);
 
-        if(const Scope<Chunk>& chunk = m_chunks[chunkID.y])
+        if(const Scope<Chunk>& chunk = m_chunks[chunkID.y]) {
+            // Chunks waiting for generation read as air, they are remeshed around once generated
+            static const BlockState AIR{};
+            if(!chunk->IsGenerated())
+                return &AIR;
+            
             return chunk->GetBlockState(blockPos);
+        }
 
         return nullptr;
     }
@@ -93,8 +80,12 @@ namespace mc
             return;
         }
 
-        if(const Scope<Chunk>& chunk = m_chunks[chunkID.y])
-            chunk->SetBlockState(blockPos, blockState);
+        if(const Scope<Chunk>& chunk = m_chunks[chunkID.y]) {
+            if(chunk->IsGenerated())
+                chunk->SetBlockState(blockPos, blockState);
+            else
+                m_pendingBlocks.push_back({blockPos, blockState});
+        }
         else
             std::cout << "Trying to set block " << blockState.GetBlock().GetName() << " on non existing chunk\n";
     }
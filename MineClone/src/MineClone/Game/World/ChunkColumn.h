@@ -4,10 +4,18 @@
 #include "Biome/Biome.h"
 #include "MineClone/Config.h"
 
+#include <mutex>
+
 namespace mc
 {
     class World;
 
+    struct BlockPlacement
+    {
+        int3 blockPos;
+        BlockState blockState;
+    };
+
     class ChunkColumn final : public IChunkProvider
     {
     public:
@@ -15,7 +23,7 @@ namespace mc
         virtual ~ChunkColumn() = default;
 
         ChunkColumn(const ChunkColumn& other) = delete;
-        ChunkColumn(ChunkColumn&& other) noexcept = default;
+        ChunkColumn(ChunkColumn&& other) noexcept = delete;
         ChunkColumn& operator=(const ChunkColumn& other) = delete;
         ChunkColumn& operator=(ChunkColumn&& other) noexcept = delete;
 
@@ -23,7 +31,6 @@ namespace mc
         void Tick();
         
         void UpdateMesh();
-        void Render();
 
     public:
         Chunk* GetChunk(int3 chunkID) override;
@@ -31,8 +38,12 @@ namespace mc
         
         const auto& GetChunks() const { return m_chunks; }
 
+        int2 GetID() const { return m_id; }
+
+        // Chunks handed to generation workers must outlive their jobs
+        bool HasChunksInFlight() const;
+
     public:
-        BlockState* GetBlockState(int3 blockPos) override;
         const BlockState* GetBlockState(int3 blockPos) const override;
         void SetBlockState(int3 blockPos, const BlockState& blockState) override;
 
@@ -40,12 +51,15 @@ namespace mc
         int2 m_id;
         World& m_world;
 
-        bool m_hasHeightMap = false;
+        // Chunks of one column may generate concurrently, the first one fills in the maps
+        std::once_flag m_heightMapFlag;
         i32 m_maxHeight;
         std::array<i32, (u64)Config::CHUNK_SIZE.x * Config::CHUNK_SIZE.z> m_heightMap{};
         std::array<const Biome*, (u64)(Config::CHUNK_SIZE.x + 1) * (Config::CHUNK_SIZE.z + 1)> m_biomeMap{};
 
         std::array<Scope<Chunk>, Config::WORLD_SIZE.y> m_chunks{};
+        // Blocks set in chunks that were not generated yet, applied once their generation completes
+        std::vector<BlockPlacement> m_pendingBlocks;
 
 
         friend class ChunkManager;
@@ -0,0 +1,92 @@
+﻿#include "mcpch.h"
+#include "ChunkColumnMap.h"
+
+namespace mc
+{
+    ChunkColumnMap::ChunkColumnMap(u64 capacity) {
+        Rehash(std::bit_ceil(std::max<u64>(capacity, 2)));
+    }
+
+    ChunkColumn* ChunkColumnMap::Find(int2 columnID) {
+        u64 key = PackKey(columnID);
+        Slot& slot = m_slots[FindSlot(key)];
+        return slot.column.get();
+    }
+
+    const ChunkColumn* ChunkColumnMap::Find(int2 columnID) const {
+        u64 key = PackKey(columnID);
+        const Slot& slot = m_slots[FindSlot(key)];
+        return slot.column.get();
+    }
+
+    ChunkColumn& ChunkColumnMap::Emplace(int2 columnID, World& world) {
+        u64 key = PackKey(columnID);
+        u64 index = FindSlot(key);
+        if(m_slots[index].column)
+            return *m_slots[index].column;
+
+        if((m_size + 1) * MAX_LOAD_DENOMINATOR > m_slots.size() * MAX_LOAD_NUMERATOR) {
+            Rehash(m_slots.size() * 2);
+            index = FindSlot(key);
+        }
+
+        Slot& slot = m_slots[index];
+        slot.key = key;
+        slot.column = CreateScope<ChunkColumn>(columnID, world);
+        m_size++;
+        return *slot.column;
+    }
+
+    bool ChunkColumnMap::Erase(int2 columnID) {
+        u64 hole = FindSlot(PackKey(columnID));
+        if(!m_slots[hole].column)
+            return false;
+
+        m_slots[hole].column.reset();
+        m_size--;
+
+        // Backward shift deletion: pull later entries of the probe sequence into the hole so lookups never need tombstones
+        u64 mask = m_slots.size() - 1;
+        for(u64 index = (hole + 1) & mask; m_slots[index].column; index = (index + 1) & mask) {
+            u64 home = GetHomeSlot(m_slots[index].key);
+
+            // Entry can move only if its home slot is not cyclically inside (hole, index]
+            if(((index - home) & mask) >= ((index - hole) & mask)) {
+                m_slots[hole] = std::move(m_slots[index]);
+                hole = index;
+            }
+        }
+
+        return true;
+    }
+
+    void ChunkColumnMap::Clear() {
+        for(Slot& slot : m_slots)
+            slot.column.reset();
+        m_size = 0;
+    }
+
+    u64 ChunkColumnMap::FindSlot(u64 key) const {
+        u64 mask = m_slots.size() - 1;
+        u64 index = GetHomeSlot(key);
+        while(m_slots[index].column && m_slots[index].key != key)
+            index = (index + 1) & mask;
+        return index;
+    }
+
+    u64 ChunkColumnMap::GetHomeSlot(u64 key) const {
+        // Fibonacci hashing spreads neighbouring coordinates across the table
+        return (key * 0x9E3779B97F4A7C15ull) >> m_shift;
+    }
+
+    void ChunkColumnMap::Rehash(u64 capacity) {
+        std::vector<Slot> old = std::move(m_slots);
+
+        m_slots = std::vector<Slot>(capacity);
+        m_shift = 64 - std::countr_zero(capacity);
+
+        for(Slot& slot : old)
+            if(slot.column)
+                m_slots[FindSlot(slot.key)] = std::move(slot);
+    }
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+#include "ChunkColumn.h"
+
+namespace mc
+{
+    // Flat open-addressing hash table of chunk columns keyed by packed column coordinates.
+    // Lookups hash the packed key once and probe linearly through a contiguous slot array.
+    // Columns are heap allocated once per insert, so their addresses stay stable across rehashes and erases.
+    class ChunkColumnMap
+    {
+    private:
+        struct Slot
+        {
+            u64 key;
+            Scope<ChunkColumn> column;
+        };
+
+        template<bool Const>
+        class Iterator
+        {
+        private:
+            using SlotPtr = std::conditional_t<Const, const Slot*, Slot*>;
+            using ColumnRef = std::conditional_t<Const, const ChunkColumn&, ChunkColumn&>;
+
+        public:
+            Iterator(SlotPtr slot, SlotPtr end)
+                : m_slot(slot), m_end(end) { SkipEmpty(); }
+
+            ColumnRef operator*() const { return *m_slot->column; }
+            Iterator& operator++() { ++m_slot; SkipEmpty(); return *this; }
+            bool operator==(const Iterator& other) const { return m_slot == other.m_slot; }
+
+        private:
+            void SkipEmpty() { while(m_slot != m_end && !m_slot->column) ++m_slot; }
+
+        private:
+            SlotPtr m_slot;
+            SlotPtr m_end;
+        };
+
+    public:
+        explicit ChunkColumnMap(u64 capacity = DEFAULT_CAPACITY);
+        ~ChunkColumnMap() = default;
+
+        ChunkColumnMap(const ChunkColumnMap& other) = delete;
+        ChunkColumnMap(ChunkColumnMap&& other) noexcept = default;
+        ChunkColumnMap& operator=(const ChunkColumnMap& other) = delete;
+        ChunkColumnMap& operator=(ChunkColumnMap&& other) noexcept = default;
+
+    public:
+        ChunkColumn* Find(int2 columnID);
+        const ChunkColumn* Find(int2 columnID) const;
+
+        // Returns the existing column if there already is one at columnID
+        ChunkColumn& Emplace(int2 columnID, World& world);
+        bool Erase(int2 columnID);
+        void Clear();
+
+    public:
+        u64 GetSize() const { return m_size; }
+        u64 GetCapacity() const { return m_slots.size(); }
+
+        Iterator<false> begin() { return {m_slots.data(), m_slots.data() + m_slots.size()}; }
+        Iterator<false> end() { return {m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()}; }
+        Iterator<true> begin() const { return {m_slots.data(), m_slots.data() + m_slots.size()}; }
+        Iterator<true> end() const { return {m_slots.data() + m_slots.size(), m_slots.data() + m_slots.size()}; }
+
+        static u64 PackKey(int2 columnID) { return (u64)(u32)columnID.x << 32 | (u32)columnID.y; }
+
+    private:
+        // Index of the slot holding key, or of the empty slot where it would be inserted
+        u64 FindSlot(u64 key) const;
+        u64 GetHomeSlot(u64 key) const;
+
+        void Rehash(u64 capacity);
+
+    private:
+        // Enough for every column inside the unload distance at a load factor below 0.5
+        static constexpr u64 COLUMNS_IN_RANGE = (u64)(2 * Config::DELETE_DISTANCE + 1) * (2 * Config::DELETE_DISTANCE + 1);
+        static constexpr u64 DEFAULT_CAPACITY = std::bit_ceil(2 * COLUMNS_IN_RANGE);
+        static constexpr u64 MAX_LOAD_NUMERATOR = 3;
+        static constexpr u64 MAX_LOAD_DENOMINATOR = 4;
+
+        std::vector<Slot> m_slots;
+        u64 m_size = 0;
+        u32 m_shift;
+    };
+}
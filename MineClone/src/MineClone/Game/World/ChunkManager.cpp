@@ -3,49 +3,125 @@
 
 #include <execution>
 
+#include "ChunkMesher.h"
 #include "Generator/ChunkGenerator.h"
+#include "MineClone/Core/Profiling/Profiler.h"
+#include "MineClone/Core/Threading/JobSystem.h"
+#include "MineClone/Core/Threading/ConcurrentQueue.h"
 
 
 namespace mc
 {
-    static std::queue<Chunk*> g_generateQueue;
+    struct GeneratedChunk
+    {
+        Chunk* chunk;
+        std::vector<BlockPlacement> outsideBlocks;
+    };
+
+    // Chunk IDs rather than pointers, chunks may be unloaded before their turn comes
+    static std::queue<int3> g_generateQueue;
+    static ConcurrentQueue<GeneratedChunk> g_generatedQueue;
+    static u32 g_chunksInFlight = 0;
+
+    static std::chrono::high_resolution_clock::time_point g_batchStart;
+    static u64 g_batchChunkCount = 0;
     
     void ChunkManager::Update(World& world) {
+        MC_PROFILE_SCOPE("ChunkManager::Update");
+        std::vector<GeneratedChunk> generated;
+        g_generatedQueue.Drain(generated);
+        for(GeneratedChunk& result : generated) {
+            g_chunksInFlight--;
+            g_batchChunkCount++;
+            OnChunkGenerated(world, *result.chunk, result.outsideBlocks);
+        }
 
-        for(int i = 0; i < 1; i++) {
-            if(g_generateQueue.empty())
-                return;
-
-            Chunk* chunk = g_generateQueue.front();
+        // Keep submissions bounded so unloads and newly queued nearby chunks are not stuck behind a long backlog
+        u32 maxChunksInFlight = JobSystem::GetWorkerCount() * MAX_JOBS_PER_WORKER;
+        while(g_chunksInFlight < maxChunksInFlight && !g_generateQueue.empty()) {
+            int3 chunkID = g_generateQueue.front();
             g_generateQueue.pop();
 
-            if(!world.GetChunk(chunk->GetID()))
+            Chunk* chunk = world.GetChunk(chunkID);
+            if(!chunk || chunk->m_state != ChunkState::Queued)
                 continue;
+
+            if(g_chunksInFlight == 0 && g_batchChunkCount == 0)
+                g_batchStart = std::chrono::high_resolution_clock::now();
+            
+            chunk->m_state = ChunkState::Generating;
+            g_chunksInFlight++;
+
+            JobSystem::Submit([chunk] {
+                GeneratedChunk result{chunk};
+                ChunkGenerator::GenerateChunk(*chunk, result.outsideBlocks);
+                g_generatedQueue.Push(std::move(result));
+            });
+        }
+
+        if(g_batchChunkCount > 0 && g_chunksInFlight == 0 && g_generateQueue.empty()) {
+            using namespace std::chrono;
+            f64 seconds = duration<f64>(high_resolution_clock::now() - g_batchStart).count();
+            std::cout << "Generated " << g_batchChunkCount << " chunks in " << duration_cast<milliseconds>(high_resolution_clock::now() - g_batchStart) << " on " << JobSystem::GetWorkerCount() << " workers (" << (u64)((f64)g_batchChunkCount / seconds) << " chunks/s)\n";
+            g_batchChunkCount = 0;
+        }
+
+        ChunkMesher::Update(world);
+    }
+
+    bool ChunkManager::IsIdle() {
+        return g_chunksInFlight == 0 && g_generateQueue.empty() && ChunkMesher::IsIdle();
+    }
+
+    void ChunkManager::OnChunkGenerated(World& world, Chunk& chunk, const std::vector<BlockPlacement>& outsideBlocks) {
+        chunk.m_state = ChunkState::Generated;
+
+        std::erase_if(chunk.m_chunkColumn.m_pendingBlocks, [&chunk](const BlockPlacement& placement) {
+            if(World::ToChunkID(placement.blockPos) != chunk.m_id)
+                return false;
+
+            chunk.m_blockStates.Set(Chunk::ToIndex(World::ToChunkPos(placement.blockPos)), placement.blockState);
+            return true;
+        });
+
+        for(const BlockPlacement& placement : outsideBlocks)
+            if(world.GetChunk(World::ToChunkID(placement.blockPos)))
+                world.SetBlockState(placement.blockPos, placement.blockState);
+
+        // Neighbours already treated this chunk as air while it was queued
+        if(chunk.IsEmpty())
+            return;
         
-            ChunkGenerator::GenerateChunk(*chunk);
-            chunk->UpdateMesh();
-            for(const Facing& face : Facing::FACINGS) {
-                int3 neighbourChunkID = chunk->m_id + face.directionVec;
-                if(Chunk* neighbour = world.GetChunk(neighbourChunkID))
-                    neighbour->UpdateMesh();
-            }
+        chunk.UpdateMesh();
+        for(const Facing& face : Facing::FACINGS) {
+            int3 neighbourChunkID = chunk.m_id + face.directionVec;
+            if(Chunk* neighbour = world.GetChunk(neighbourChunkID))
+                neighbour->UpdateMesh();
         }
     }
 
     void ChunkManager::UpdatePlayer(World& world, int3 currentChunkID) {
+        MC_PROFILE_SCOPE("ChunkManager::UpdatePlayer");
 
         using namespace std::chrono;
         auto start = high_resolution_clock::now();
 
-        constexpr i32 deleteDistance = (i32)(Config::RENDER_DISTANCE * 1.25f);
+        constexpr i32 deleteDistance = Config::DELETE_DISTANCE;
 
-        auto idsView = world.m_chunkColumns | std::views::keys;
-        std::vector<int2> columnsIDs{std::begin(idsView), std::end(idsView)};
+        std::vector<int2> columnsIDs;
+        columnsIDs.reserve(world.m_chunkColumns.GetSize());
+        for(const ChunkColumn& column : world.m_chunkColumns)
+            columnsIDs.push_back(column.GetID());
+        
         for(int2 columnID : columnsIDs) {
             int2 columnPosDelta = abs(columnID - int2{currentChunkID.xz});
 
+            ChunkColumn& column = *world.m_chunkColumns.Find(columnID);
+
+            // Columns and chunks still being generated are unloaded on a later move
             if(columnPosDelta.x > deleteDistance || columnPosDelta.y > deleteDistance) {
-                world.m_chunkColumns.erase(columnID);
+                if(!column.HasChunksInFlight())
+                    world.m_chunkColumns.Erase(columnID);
                 continue;
             }
 
@@ -53,9 +129,9 @@ namespace mc
                 if(abs(y - currentChunkID.y) <= deleteDistance)
                     continue;
                 
-                Scope<Chunk>& chunk = world.m_chunkColumns.at(columnID).m_chunks.at(y);
+                Scope<Chunk>& chunk = column.m_chunks.at(y);
 
-                if(!chunk)
+                if(!chunk || chunk->GetState() == ChunkState::Generating)
                     continue;
                 
                 chunk.reset();
@@ -68,23 +144,25 @@ namespace mc
             if(IsOutsideWorld(chunkID))
                 return;
 
-            int2 columnID = chunkID.xz;
-
-            ChunkColumn* column = nullptr;
-            if(world.m_chunkColumns.contains(columnID))
-                column = &world.m_chunkColumns.at(columnID);
-            else
-                column = &world.m_chunkColumns.emplace(columnID, ChunkColumn(columnID, world)).first->second;
-
-            if(column->GetChunk(chunkID))
+            ChunkColumn& column = world.m_chunkColumns.Emplace(chunkID.xz, world);
+            if(column.GetChunk(chunkID))
                 return;
                 
-            Chunk& chunk = CreateChunk(*column, chunkID);
-            g_generateQueue.push(&chunk);
+            Chunk& chunk = CreateChunk(column, chunkID);
+            g_generateQueue.push(chunk.GetID());
             chunkCount++;
         });        
         
-        std::cout << "Generation of " << chunkCount << " chunks for player at chunkID: " << to_string(currentChunkID) << ", took " << duration_cast<milliseconds>(high_resolution_clock::now() - start) << '\n';
+        u64 chunkMemory = 0;
+        u64 uniformChunks = 0;
+        for(const ChunkColumn& column : world.m_chunkColumns)
+            for(const Scope<Chunk>& chunk : column.GetChunks())
+                if(chunk && chunk->IsGenerated()) {
+                    chunkMemory += chunk->GetMemoryUsage();
+                    uniformChunks += chunk->IsUniform();
+                }
+        
+        std::cout << "Generation of " << chunkCount << " chunks for player at chunkID: " << to_string(currentChunkID) << ", took " << duration_cast<milliseconds>(high_resolution_clock::now() - start) << ", resident chunk memory: " << chunkMemory / 1024 << " KiB (" << uniformChunks << " uniform chunks), chunk pool: " << ChunkPool::GetOccupancy() << '/' << ChunkPool::GetCapacity() << " (peak " << ChunkPool::GetHighWaterMark() << ", " << ChunkPool::GetOverflowCount() << " overflowed)\n";
     }
 
     Chunk& ChunkManager::CreateChunk(ChunkColumn& column, int3 chunkID) {
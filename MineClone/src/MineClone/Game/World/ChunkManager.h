@@ -10,7 +10,16 @@ namespace mc
         
         static void UpdatePlayer(World& world, int3 currentChunkID);
 
+        // Every queued chunk generated and meshed
+        static bool IsIdle();
+
         static Chunk& CreateChunk(ChunkColumn& column, int3 chunkID);
         static bool IsOutsideWorld(int3 chunkID);
+
+    private:
+        static void OnChunkGenerated(World& world, Chunk& chunk, const std::vector<BlockPlacement>& outsideBlocks);
+
+    private:
+        static constexpr u32 MAX_JOBS_PER_WORKER = 4;
     };
 }
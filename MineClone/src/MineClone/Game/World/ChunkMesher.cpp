@@ -0,0 +1,289 @@
+﻿#include "mcpch.h"
+#include "ChunkMesher.h"
+
+#include "World.h"
+#include "MineClone/Core/Profiling/Profiler.h"
+#include "MineClone/Core/Renderer/RendererAPI.h"
+#include "MineClone/Core/Threading/JobSystem.h"
+#include "MineClone/Game/Utils/Facing.h"
+
+namespace mc
+{
+    void ChunkMesher::QueueRemesh(Chunk& chunk) {
+        if(!chunk.IsGenerated() || chunk.m_remeshQueued)
+            return;
+
+        chunk.m_remeshQueued = true;
+        s_remeshQueue.push_back(chunk.m_id);
+    }
+
+    void ChunkMesher::Update(World& world) {
+        MC_PROFILE_SCOPE("ChunkMesher::Update");
+        std::vector<MeshData> meshes;
+        s_meshedQueue.Drain(meshes);
+        s_meshesInFlight -= (u32)meshes.size();
+        for(MeshData& mesh : meshes) {
+            Chunk* chunk = world.GetChunk(mesh.chunkID);
+            if(!chunk || chunk->m_meshRevision != mesh.revision)
+                continue;
+
+            // The replaced range is released once no frame draws it anymore
+            GeometryArena::Free(chunk->m_geometry);
+            chunk->m_geometry = GeometryArena::Upload(mesh.vertices);
+            if(chunk->m_geometry.IsValid()) {
+                RendererAPI::ReserveQuadIndices(chunk->m_geometry.quadCount);
+                chunk->m_mesh.Dispose();
+            }
+            else
+                chunk->m_mesh.SetQuads(std::span(mesh.vertices));
+
+            chunk->m_visibility = mesh.visibility;
+            chunk->m_occluder = mesh.occluder;
+            chunk->m_facingQuadOffsets = mesh.facingQuadOffsets;
+        }
+
+        for(int3 chunkID : s_remeshQueue) {
+            Chunk* chunk = world.GetChunk(chunkID);
+            if(!chunk || !chunk->m_remeshQueued)
+                continue;
+
+            chunk->m_remeshQueued = false;
+            
+            // Revisions are global, so a chunk unloaded and recreated with the same ID never accepts an old mesh
+            u64 revision = ++s_revision;
+            chunk->m_meshRevision = revision;
+
+            if(chunk->IsEmpty()) {
+                chunk->m_mesh.Dispose();
+                GeometryArena::Free(chunk->m_geometry);
+                chunk->m_geometry = {};
+                chunk->m_visibility = ChunkVisibility::All();
+                chunk->m_occluder = {};
+                chunk->m_facingQuadOffsets = {};
+                continue;
+            }
+
+            s_meshesInFlight++;
+            JobSystem::Submit([snapshot = CreateSnapshot(*chunk), revision] {
+                MC_PROFILE_SCOPE("ChunkMesher::Build");
+                MeshData mesh{snapshot.chunkID, revision};
+                Build(snapshot, mesh);
+                mesh.visibility = ChunkVisibility::Compute(snapshot.blockStates);
+                mesh.occluder = ChunkOccluder::Compute(snapshot.blockStates);
+                s_meshedQueue.Push(std::move(mesh));
+            });
+        }
+        s_remeshQueue.clear();
+    }
+
+    ChunkMesher::Snapshot ChunkMesher::CreateSnapshot(const Chunk& chunk) {
+        Snapshot snapshot{chunk.m_id, s_mode, chunk.m_blockStates};
+
+        for(const Facing& facing : Facing::FACINGS) {
+            std::array<NeighbourBlock, SLICE_AREA>& slice = snapshot.neighbours[facing.index];
+            const Chunk* neighbour = chunk.m_chunkColumn.GetChunk(chunk.m_id + facing.directionVec);
+
+            if(!neighbour) {
+                slice.fill(NeighbourBlock::Missing);
+                continue;
+            }
+
+            // Chunks waiting for generation read as air, they remesh their neighbours once generated
+            if(!neighbour->IsGenerated()) {
+                slice.fill(NeighbourBlock::Transparent);
+                continue;
+            }
+
+            if(neighbour->IsUniform()) {
+                slice.fill(neighbour->m_blockStates.Get(0).IsTransparent() ? NeighbourBlock::Transparent : NeighbourBlock::Opaque);
+                continue;
+            }
+
+            for(i32 b = 0; b < Config::CHUNK_SIZE.y; b++)
+                for(i32 a = 0; a < Config::CHUNK_SIZE.x; a++) {
+                    // Boundary block of this chunk, then the touching block on the other side wrapped into the neighbour
+                    int3 chunkPos = facing.directionVec.x != 0 ? int3{0, a, b} :
+                                    facing.directionVec.y != 0 ? int3{a, 0, b} :
+                                                                 int3{a, b, 0};
+                    if(facing.directionVec.x > 0) chunkPos.x = Config::CHUNK_SIZE.x - 1;
+                    if(facing.directionVec.y > 0) chunkPos.y = Config::CHUNK_SIZE.y - 1;
+                    if(facing.directionVec.z > 0) chunkPos.z = Config::CHUNK_SIZE.z - 1;
+
+                    int3 neighbourPos = (chunkPos + facing.directionVec + Config::CHUNK_SIZE) % Config::CHUNK_SIZE;
+                    slice[ToSliceIndex(facing.index, chunkPos)] = neighbour->m_blockStates.Get(Chunk::ToIndex(neighbourPos)).IsTransparent() ?
+                        NeighbourBlock::Transparent : NeighbourBlock::Opaque;
+                }
+        }
+
+        return snapshot;
+    }
+
+    void ChunkMesher::Build(const Snapshot& snapshot, MeshData& mesh) {
+        switch(snapshot.mode) {
+        case Mode::Naive:
+            BuildNaive(snapshot, mesh);
+            break;
+        case Mode::Greedy:
+            BuildGreedy(snapshot, mesh);
+            break;
+        }
+
+        SortByFacing(mesh);
+    }
+
+    void ChunkMesher::BuildNaive(const Snapshot& snapshot, MeshData& mesh) {
+        const BlockStorage& blockStates = snapshot.blockStates;
+        
+        // Inside a uniform opaque chunk only the outer shell can have exposed faces
+        bool shellOnly = blockStates.IsUniform();
+        
+        for(i32 z = 0; z < Config::CHUNK_SIZE.z; z++)
+            for(i32 y = 0; y < Config::CHUNK_SIZE.y; y++)
+                for(i32 x = 0; x < Config::CHUNK_SIZE.x; x++) {
+                    if(shellOnly && x == 1 &&
+                       z > 0 && z < Config::CHUNK_SIZE.z - 1 &&
+                       y > 0 && y < Config::CHUNK_SIZE.y - 1)
+                        x = Config::CHUNK_SIZE.x - 1;
+                    
+                    int3 chunkPos = {x, y, z};
+                    const BlockState& current = blockStates.Get(Chunk::ToIndex(chunkPos));
+
+                    if(current.IsTransparent())
+                        continue;
+                    
+                    for(u32 i = 0; i < (u32)Facing::FACINGS.size(); i++)
+                        if(IsFaceExposed(snapshot, chunkPos, i))
+                            AddQuad(mesh, i, chunkPos, {1, 1, 1}, current.GetBlockIndex());
+                }
+    }
+
+    void ChunkMesher::BuildGreedy(const Snapshot& snapshot, MeshData& mesh) {
+        const BlockStorage& blockStates = snapshot.blockStates;
+        constexpr i32 SIZE = Config::CHUNK_SIZE.x;
+
+        // Texture index + 1 of the exposed face at each cell of the current layer, 0 where there is none
+        std::array<u32, SLICE_AREA> mask;
+        
+        for(u32 i = 0; i < (u32)Facing::FACINGS.size(); i++) {
+            const int3& direction = Facing::FACINGS[i].directionVec;
+            i32 normalAxis = direction.x != 0 ? 0 : direction.y != 0 ? 1 : 2;
+            i32 uAxis = (normalAxis + 1) % 3;
+            i32 vAxis = (normalAxis + 2) % 3;
+
+            for(i32 layer = 0; layer < SIZE; layer++) {
+                int3 chunkPos;
+                chunkPos[normalAxis] = layer;
+
+                bool anyFace = false;
+                for(i32 v = 0; v < SIZE; v++)
+                    for(i32 u = 0; u < SIZE; u++) {
+                        chunkPos[uAxis] = u;
+                        chunkPos[vAxis] = v;
+                        
+                        const BlockState& current = blockStates.Get(Chunk::ToIndex(chunkPos));
+                        u32 key = 0;
+                        if(!current.IsTransparent() && IsFaceExposed(snapshot, chunkPos, i))
+                            key = BlockTable::GetTextureIndex(current.GetBlockIndex(), i) + 1u;
+                        
+                        mask[u + v * SIZE] = key;
+                        anyFace |= key != 0;
+                    }
+
+                if(!anyFace)
+                    continue;
+
+                for(i32 v = 0; v < SIZE; v++)
+                    for(i32 u = 0; u < SIZE;) {
+                        u32 key = mask[u + v * SIZE];
+                        if(key == 0) {
+                            u++;
+                            continue;
+                        }
+
+                        i32 width = 1;
+                        while(u + width < SIZE && mask[u + width + v * SIZE] == key)
+                            width++;
+
+                        i32 height = 1;
+                        while(v + height < SIZE &&
+                              std::all_of(&mask[u + (v + height) * SIZE], &mask[u + width + (v + height) * SIZE], [key](u32 other) { return other == key; }))
+                            height++;
+
+                        for(i32 dv = 0; dv < height; dv++)
+                            std::fill_n(&mask[u + (v + dv) * SIZE], width, 0u);
+
+                        int3 origin;
+                        origin[normalAxis] = layer;
+                        origin[uAxis] = u;
+                        origin[vAxis] = v;
+
+                        int3 size = {1, 1, 1};
+                        size[uAxis] = width;
+                        size[vAxis] = height;
+
+                        chunkPos[uAxis] = u;
+                        chunkPos[vAxis] = v;
+                        AddQuad(mesh, i, origin, size, blockStates.Get(Chunk::ToIndex(chunkPos)).GetBlockIndex());
+                        
+                        u += width;
+                    }
+            }
+        }
+    }
+
+    void ChunkMesher::SortByFacing(MeshData& mesh) {
+        u32 quadCount = (u32)mesh.vertices.size() / 4;
+
+        std::array<u32, 6> counts{};
+        for(u32 quad = 0; quad < quadCount; quad++)
+            counts[mesh.vertices[quad * 4].GetFace()]++;
+
+        mesh.facingQuadOffsets[0] = 0;
+        for(u32 i = 0; i < 6; i++)
+            mesh.facingQuadOffsets[i + 1] = mesh.facingQuadOffsets[i] + counts[i];
+
+        // The greedy mesher already emits one facing after the other
+        if(std::ranges::is_sorted(std::views::iota(0u, quadCount), {}, [&](u32 quad) { return mesh.vertices[quad * 4].GetFace(); }))
+            return;
+
+        std::vector<ChunkVertex> sorted(mesh.vertices.size());
+        std::array<u32, 7> next = mesh.facingQuadOffsets;
+        for(u32 quad = 0; quad < quadCount; quad++) {
+            u32 target = next[mesh.vertices[quad * 4].GetFace()]++;
+            std::copy_n(&mesh.vertices[quad * 4], 4, &sorted[target * 4]);
+        }
+
+        mesh.vertices = std::move(sorted);
+    }
+
+    bool ChunkMesher::IsFaceExposed(const Snapshot& snapshot, int3 chunkPos, u32 face) {
+        int3 neighbourPos = chunkPos + Facing::FACINGS[face].directionVec;
+        
+        if(neighbourPos.x < 0 || neighbourPos.x >= Config::CHUNK_SIZE.x ||
+           neighbourPos.y < 0 || neighbourPos.y >= Config::CHUNK_SIZE.y ||
+           neighbourPos.z < 0 || neighbourPos.z >= Config::CHUNK_SIZE.z) {
+            NeighbourBlock neighbour = snapshot.neighbours[face][ToSliceIndex(face, chunkPos)];
+            return neighbour == NeighbourBlock::Transparent ||
+                   neighbour == NeighbourBlock::Missing && chunkPos.y == Config::CHUNK_SIZE.y - 1;
+        }
+
+        return snapshot.blockStates.Get(Chunk::ToIndex(neighbourPos)).IsTransparent();
+    }
+
+    void ChunkMesher::AddQuad(MeshData& mesh, u32 face, int3 origin, int3 size, u16 blockIndex) {
+        const std::array<Vertex3D, 4>& corners = Config::VERTICES[face];
+        u32 tile = BlockTable::GetTextureIndex(blockIndex, face);
+        
+        for(u32 corner = 0; corner < (u32)corners.size(); corner++)
+            mesh.vertices.push_back(ChunkVertex::Pack(origin + int3(corners[corner].pos) * size, face, corner, tile));
+    }
+
+    u64 ChunkMesher::ToSliceIndex(u32 face, int3 chunkPos) {
+        const int3& direction = Facing::FACINGS[face].directionVec;
+        if(direction.x != 0)
+            return (u64)chunkPos.y + (u64)chunkPos.z * Config::CHUNK_SIZE.y;
+        if(direction.y != 0)
+            return (u64)chunkPos.x + (u64)chunkPos.z * Config::CHUNK_SIZE.x;
+        return (u64)chunkPos.x + (u64)chunkPos.y * Config::CHUNK_SIZE.x;
+    }
+}
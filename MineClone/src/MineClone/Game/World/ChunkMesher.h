@@ -0,0 +1,101 @@
+﻿#pragma once
+#include "BlockStorage.h"
+#include "ChunkOccluder.h"
+#include "ChunkVisibility.h"
+#include "MineClone/Config.h"
+#include "MineClone/Core/Threading/ConcurrentQueue.h"
+
+namespace mc
+{
+    class Chunk;
+    class World;
+
+    // Builds chunk meshes on JobSystem workers from immutable snapshots, so workers never read live chunks.
+    // Only the buffer upload of finished meshes runs on the main thread.
+    class ChunkMesher
+    {
+    public:
+        enum class Mode : u8
+        {
+            // One quad per exposed block face
+            Naive,
+            // Coplanar faces with the same texture merged into larger quads
+            Greedy,
+        };
+
+    private:
+        static constexpr u64 SLICE_AREA = (u64)Config::CHUNK_SIZE.x * Config::CHUNK_SIZE.y;
+
+        enum class NeighbourBlock : u8
+        {
+            Missing,
+            Transparent,
+            Opaque,
+        };
+
+    public:
+        struct Snapshot
+        {
+            int3 chunkID;
+            Mode mode;
+            BlockStorage blockStates;
+            // Blocks of the six neighbouring chunks touching this chunk's faces, indexed by Facing
+            std::array<std::array<NeighbourBlock, SLICE_AREA>, 6> neighbours;
+        };
+
+        struct MeshData
+        {
+            int3 chunkID;
+            u64 revision;
+
+            // 4 vertices per quad, drawn with the shared quad index buffer.
+            // Quads are grouped by Facing, the quads of facing i are [facingQuadOffsets[i], facingQuadOffsets[i + 1]).
+            std::vector<ChunkVertex> vertices;
+            std::array<u32, 7> facingQuadOffsets{};
+            ChunkVisibility visibility;
+            ChunkOccluder occluder;
+        };
+
+    public:
+        // Remeshes are deduplicated per chunk and dispatched on the next Update
+        static void QueueRemesh(Chunk& chunk);
+
+        // Uploads finished meshes, dropping the ones a newer remesh superseded, then dispatches queued remeshes
+        static void Update(World& world);
+
+        // No remesh queued or still being built
+        static bool IsIdle() { return s_remeshQueue.empty() && s_meshesInFlight == 0; }
+
+    public:
+        static Snapshot CreateSnapshot(const Chunk& chunk);
+        static void Build(const Snapshot& snapshot, MeshData& mesh);
+
+    public:
+        static Mode GetMode() { return s_mode; }
+        // Takes effect for remeshes dispatched afterwards, see World::UpdateMesh
+        static void SetMode(Mode mode) { s_mode = mode; }
+
+    private:
+        static void BuildNaive(const Snapshot& snapshot, MeshData& mesh);
+        static void BuildGreedy(const Snapshot& snapshot, MeshData& mesh);
+        // Stable counting sort of the built quads by facing
+        static void SortByFacing(MeshData& mesh);
+
+        static bool IsFaceExposed(const Snapshot& snapshot, int3 chunkPos, u32 face);
+        // Quad covering size blocks from origin, facing face
+        static void AddQuad(MeshData& mesh, u32 face, int3 origin, int3 size, u16 blockIndex);
+
+        static u64 ToSliceIndex(u32 face, int3 chunkPos);
+
+    private:
+        static_assert(Config::CHUNK_SIZE.x == Config::CHUNK_SIZE.y && Config::CHUNK_SIZE.y == Config::CHUNK_SIZE.z, "Neighbour slices assume cubic chunks");
+
+        inline static Mode s_mode = Mode::Greedy;
+
+        inline static std::vector<int3> s_remeshQueue;
+        inline static ConcurrentQueue<MeshData> s_meshedQueue;
+        inline static u64 s_revision = 0;
+        // Only touched on the main thread, jobs report back through s_meshedQueue
+        inline static u32 s_meshesInFlight = 0;
+    };
+}
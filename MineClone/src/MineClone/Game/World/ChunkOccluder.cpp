@@ -0,0 +1,61 @@
+﻿#include "mcpch.h"
+#include "ChunkOccluder.h"
+
+#include "Chunk.h"
+#include "MineClone/Core/Renderer/OcclusionBuffer.h"
+
+namespace mc
+{
+    ChunkOccluder ChunkOccluder::Compute(const BlockStorage& blockStates) {
+        ChunkOccluder occluder;
+
+        if(blockStates.IsUniform()) {
+            if(!blockStates.Get(0).IsTransparent())
+                occluder.m_heights.fill((u8)Config::CHUNK_SIZE.y);
+            return occluder;
+        }
+
+        for(i32 tileZ = 0; tileZ < TILE_COUNT; tileZ++)
+            for(i32 tileX = 0; tileX < TILE_COUNT; tileX++) {
+                u8& height = occluder.m_heights[tileZ * TILE_COUNT + tileX];
+
+                for(i32 y = 0; y < Config::CHUNK_SIZE.y; y++, height++) {
+                    bool solid = true;
+                    for(i32 z = tileZ * TILE_SIZE; solid && z < (tileZ + 1) * TILE_SIZE; z++)
+                        for(i32 x = tileX * TILE_SIZE; solid && x < (tileX + 1) * TILE_SIZE; x++)
+                            solid = !blockStates.Get(Chunk::ToIndex({x, y, z})).IsTransparent();
+
+                    if(!solid)
+                        break;
+                }
+            }
+
+        return occluder;
+    }
+
+    void ChunkOccluder::AddTo(OcclusionBuffer& buffer, int3 chunkOrigin) const {
+        // Solid chunks and flat ground are one box
+        if(std::ranges::all_of(m_heights, [this](u8 height) { return height == m_heights[0]; })) {
+            if(m_heights[0] > 0)
+                buffer.AddOccluder(float3(chunkOrigin), float3(chunkOrigin + int3(Config::CHUNK_SIZE.x, m_heights[0], Config::CHUNK_SIZE.z)));
+            return;
+        }
+
+        for(i32 tileZ = 0; tileZ < TILE_COUNT; tileZ++)
+            for(i32 tileX = 0; tileX < TILE_COUNT;) {
+                u8 height = GetHeight(tileX, tileZ);
+
+                i32 endX = tileX + 1;
+                while(endX < TILE_COUNT && GetHeight(endX, tileZ) == height)
+                    endX++;
+
+                if(height > 0) {
+                    float3 min = float3(chunkOrigin + int3(tileX * TILE_SIZE, 0, tileZ * TILE_SIZE));
+                    float3 max = float3(chunkOrigin + int3(endX * TILE_SIZE, height, (tileZ + 1) * TILE_SIZE));
+                    buffer.AddOccluder(min, max);
+                }
+
+                tileX = endX;
+            }
+    }
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include "BlockStorage.h"
+#include "MineClone/Config.h"
+
+namespace mc
+{
+    class OcclusionBuffer;
+
+    // Coarse solid volume of a chunk for the software occlusion buffer. The chunk is split into columns of
+    // TILE_SIZE x TILE_SIZE blocks, each storing how many layers from the chunk bottom are completely opaque.
+    class ChunkOccluder
+    {
+    public:
+        static constexpr i32 TILE_SIZE = 4;
+        static constexpr i32 TILE_COUNT = Config::CHUNK_SIZE.x / TILE_SIZE;
+
+    public:
+        constexpr ChunkOccluder() = default;
+
+        static ChunkOccluder Compute(const BlockStorage& blockStates);
+
+        // Adds one box per run of equally high tiles along x, offset by the chunk's block position
+        void AddTo(OcclusionBuffer& buffer, int3 chunkOrigin) const;
+
+    public:
+        bool IsEmpty() const { return std::ranges::all_of(m_heights, [](u8 height) { return height == 0; }); }
+        u8 GetHeight(i32 tileX, i32 tileZ) const { return m_heights[tileZ * TILE_COUNT + tileX]; }
+
+    private:
+        static_assert(Config::CHUNK_SIZE.x % TILE_SIZE == 0 && Config::CHUNK_SIZE.x == Config::CHUNK_SIZE.z, "Occluder tiles must evenly cover the chunk");
+
+        std::array<u8, TILE_COUNT * TILE_COUNT> m_heights{};
+    };
+}
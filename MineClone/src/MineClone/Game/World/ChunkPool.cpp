@@ -0,0 +1,53 @@
+﻿#include "mcpch.h"
+#include "ChunkPool.h"
+
+#include "Chunk.h"
+
+namespace mc
+{
+    void* ChunkPool::Allocate(u64 size) {
+        if(!s_slab)
+            Init();
+
+        void* ptr;
+        if(size <= s_slotSize && !s_freeSlots.empty()) {
+            ptr = s_slab + s_freeSlots.back() * s_slotSize;
+            s_freeSlots.pop_back();
+        }
+        else {
+            ptr = ::operator new(size, std::align_val_t{alignof(Chunk)});
+            s_overflowCount++;
+        }
+
+        s_occupancy++;
+        s_highWaterMark = std::max(s_highWaterMark, s_occupancy);
+        return ptr;
+    }
+
+    void ChunkPool::Free(void* ptr) {
+        if(!ptr)
+            return;
+
+        s_occupancy--;
+
+        if(Owns(ptr))
+            s_freeSlots.push_back((u32)(((std::byte*)ptr - s_slab) / s_slotSize));
+        else
+            ::operator delete(ptr, std::align_val_t{alignof(Chunk)});
+    }
+
+    void ChunkPool::Init() {
+        s_slotSize = (sizeof(Chunk) + alignof(Chunk) - 1) / alignof(Chunk) * alignof(Chunk);
+        // Never released, chunks may still be destroyed during static destruction
+        s_slab = (std::byte*)::operator new(CAPACITY * s_slotSize, std::align_val_t{alignof(Chunk)});
+
+        // Reversed so the lowest slots are handed out first
+        s_freeSlots.reserve(CAPACITY);
+        for(u64 i = CAPACITY; i > 0; i--)
+            s_freeSlots.push_back((u32)(i - 1));
+    }
+
+    bool ChunkPool::Owns(const void* ptr) {
+        return s_slab && ptr >= s_slab && ptr < s_slab + CAPACITY * s_slotSize;
+    }
+}
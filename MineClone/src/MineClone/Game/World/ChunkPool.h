@@ -0,0 +1,38 @@
+﻿#pragma once
+#include "MineClone/Config.h"
+
+namespace mc
+{
+    // Fixed capacity slab backing every Chunk allocation (see Chunk::operator new).
+    // Sized for all chunks inside the unload distance, so streaming recycles slots instead of churning the heap.
+    // Allocations past capacity fall back to the global heap and are counted as overflows.
+    // Not thread safe, chunks are created and destroyed on the main thread only.
+    class ChunkPool
+    {
+    public:
+        static void* Allocate(u64 size);
+        static void Free(void* ptr);
+
+    public:
+        static u64 GetCapacity() { return CAPACITY; }
+        static u64 GetOccupancy() { return s_occupancy; }
+        static u64 GetHighWaterMark() { return s_highWaterMark; }
+        static u64 GetOverflowCount() { return s_overflowCount; }
+
+    private:
+        static void Init();
+        static bool Owns(const void* ptr);
+
+    private:
+        static constexpr u64 COLUMNS = (u64)(2 * Config::DELETE_DISTANCE + 1) * (2 * Config::DELETE_DISTANCE + 1);
+        static constexpr u64 CAPACITY = COLUMNS * std::min<u64>(Config::WORLD_SIZE.y, 2 * Config::DELETE_DISTANCE + 1);
+
+        inline static std::byte* s_slab = nullptr;
+        inline static u64 s_slotSize = 0;
+        inline static std::vector<u32> s_freeSlots;
+
+        inline static u64 s_occupancy = 0;
+        inline static u64 s_highWaterMark = 0;
+        inline static u64 s_overflowCount = 0;
+    };
+}
@@ -0,0 +1,65 @@
+﻿#include "mcpch.h"
+#include "ChunkVisibility.h"
+
+#include <bitset>
+
+#include "Chunk.h"
+#include "MineClone/Game/Utils/Facing.h"
+
+namespace mc
+{
+    ChunkVisibility ChunkVisibility::Compute(const BlockStorage& blockStates) {
+        if(blockStates.IsUniform())
+            return blockStates.Get(0).IsTransparent() ? All() : ChunkVisibility{};
+
+        std::bitset<Chunk::VOLUME> closed;
+        for(u64 i = 0; i < Chunk::VOLUME; i++)
+            closed[i] = !blockStates.Get(i).IsTransparent();
+
+        ChunkVisibility visibility;
+        std::vector<int3> stack;
+        stack.reserve(Chunk::VOLUME);
+
+        for(i32 z = 0; z < Config::CHUNK_SIZE.z; z++)
+            for(i32 y = 0; y < Config::CHUNK_SIZE.y; y++)
+                for(i32 x = 0; x < Config::CHUNK_SIZE.x; x++) {
+                    u64 start = Chunk::ToIndex({x, y, z});
+                    if(closed[start])
+                        continue;
+
+                    // Faces touched by this open region, blocks are closed once visited
+                    u32 faces = 0;
+                    closed[start] = true;
+                    stack.push_back({x, y, z});
+
+                    while(!stack.empty()) {
+                        int3 pos = stack.back();
+                        stack.pop_back();
+
+                        for(const Facing& facing : Facing::FACINGS) {
+                            int3 next = pos + facing.directionVec;
+                            if(next.x < 0 || next.x >= Config::CHUNK_SIZE.x ||
+                               next.y < 0 || next.y >= Config::CHUNK_SIZE.y ||
+                               next.z < 0 || next.z >= Config::CHUNK_SIZE.z) {
+                                faces |= 1u << facing.index;
+                                continue;
+                            }
+
+                            u64 index = Chunk::ToIndex(next);
+                            if(closed[index])
+                                continue;
+
+                            closed[index] = true;
+                            stack.push_back(next);
+                        }
+                    }
+
+                    for(u32 from = 0; from < 6; from++)
+                        for(u32 to = from; to < 6; to++)
+                            if(faces >> from & 1 && faces >> to & 1)
+                                visibility.Connect(from, to);
+                }
+
+        return visibility;
+    }
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include "BlockStorage.h"
+
+namespace mc
+{
+    // Which pairs of a chunk's six faces are connected through non-opaque blocks, indexed by Facing.
+    // A camera looking into the chunk through one face can only see out of faces connected to it.
+    class ChunkVisibility
+    {
+    public:
+        constexpr ChunkVisibility() = default;
+
+        // Every face sees every other face, used for air and for chunks whose contents are unknown
+        static constexpr ChunkVisibility All() { ChunkVisibility visibility; visibility.m_connections = (1ull << 36) - 1; return visibility; }
+
+        // Flood fills the non-opaque blocks and connects all faces each open region touches
+        static ChunkVisibility Compute(const BlockStorage& blockStates);
+
+    public:
+        bool IsConnected(u32 from, u32 to) const { return m_connections >> (from * 6 + to) & 1; }
+        void Connect(u32 from, u32 to) { m_connections |= 1ull << (from * 6 + to) | 1ull << (to * 6 + from); }
+
+    private:
+        u64 m_connections = 0;
+    };
+}
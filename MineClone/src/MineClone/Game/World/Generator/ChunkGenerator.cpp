@@ -1,6 +1,7 @@
 ﻿#include "mcpch.h"
 #include "ChunkGenerator.h"
 
+#include "MineClone/Core/Profiling/Profiler.h"
 #include "MineClone/Game/World/World.h"
 #include "MineClone/Game/World/Biome/Biome.h"
 
@@ -24,16 +25,18 @@ namespace mc
         Biome::Init(seed);
     }
 
-    void ChunkGenerator::GenerateChunk(Chunk& chunk) {
+    void ChunkGenerator::GenerateChunk(Chunk& chunk, std::vector<BlockPlacement>& outsideBlocks) {
+        MC_PROFILE_SCOPE("ChunkGenerator::GenerateChunk");
         ChunkColumn& column = chunk.m_chunkColumn;
         int2 columnID = column.m_id;
         Random<std::minstd_rand> random{(columnID.x ^ columnID.y) << 2};
 
-        if(!column.m_hasHeightMap) {
+        std::call_once(column.m_heightMapFlag, [&column] {
             GenerateBiomeMap(column);
             GenerateHeightMap(column);
-        }
+        });
         
+        // Sky chunks stay uniform air and never allocate block storage
         int3 blockPos = chunk.m_id * Config::CHUNK_SIZE;
         if(blockPos.y > column.m_maxHeight)
             return;
@@ -69,8 +72,7 @@ namespace mc
                                     if(dy < 15)
                                         SetBlock(chunk, {x, dy + 1, z}, plant);
                                     else
-                                        if(Scope<Chunk>& ch = column.m_chunks[chunk.m_id.y + 1])
-                                            SetBlock(*ch, {x, 0, z}, plant);
+                                        outsideBlocks.push_back({blockPos + int3{x, dy + 1, z}, plant});
                                 }
                                 
                                 blockState = biome->GetTopBlock(random);
@@ -90,6 +92,8 @@ namespace mc
                 }
             }
 
+        chunk.m_blockStates.Compact();
+
         // for (auto &tree : trees) {
         //     int x = tree.x;
         //     int z = tree.z;
@@ -99,7 +103,7 @@ namespace mc
     }
 
     void ChunkGenerator::SetBlock(Chunk& chunk, int3 pos, const BlockState& blockState) {
-        chunk.m_blockStates[Chunk::ToIndex(pos)] = blockState;
+        chunk.m_blockStates.Set(Chunk::ToIndex(pos), blockState);
     }
 
     void ChunkGenerator::GenerateBiomeMap(ChunkColumn& chunkColumn) {
@@ -12,7 +12,9 @@ namespace mc
     public:
         static void Init(i32 seed);
 
-        static void GenerateChunk(Chunk& chunk);
+        // Thread safe for distinct chunks. Blocks that spill into other chunks are returned in outsideBlocks
+        // for the main thread to place.
+        static void GenerateChunk(Chunk& chunk, std::vector<BlockPlacement>& outsideBlocks);
 
     private:
         static void SetBlock(Chunk& chunk, int3 pos, const BlockState& blockState);
@@ -16,7 +16,6 @@ namespace mc
         IBlockStateProvider& operator=(IBlockStateProvider&&) = default;
 
     public:
-        virtual BlockState* GetBlockState(int3 blockPos) = 0;
         virtual const BlockState* GetBlockState(int3 blockPos) const = 0;
 
         virtual void SetBlockState(int3 blockPos, const BlockState& blockState) = 0;
@@ -2,19 +2,212 @@
 #include "World.h"
 
 #include "Generator/ChunkGenerator.h"
+#include "MineClone/Core/Profiling/Profiler.h"
+#include "MineClone/Core/Renderer/Frustum.h"
+#include "MineClone/Core/Renderer/RendererAPI.h"
+#include "MineClone/Game/Utils/Facing.h"
 
 namespace mc
 {
     World::World() {}
 
     void World::Tick() {
-        for(auto& chunkColumn : m_chunkColumns | std::views::values)
+        for(ChunkColumn& chunkColumn : m_chunkColumns)
             chunkColumn.Tick();
     }
 
-    void World::Render() {
-        for(auto& chunkColumn : m_chunkColumns | std::views::values)
-            chunkColumn.Render();
+    void World::Render(const Camera& camera) {
+        MC_PROFILE_SCOPE("World::Render");
+        m_renderStats = {};
+        m_renderChunks.clear();
+        m_renderCenterX.clear();
+        m_renderCenterY.clear();
+        m_renderCenterZ.clear();
+
+        float3 halfExtent = float3(Config::CHUNK_SIZE) * 0.5f;
+
+        using namespace std::chrono;
+        auto cullStart = high_resolution_clock::now();
+
+        Mat4 viewProjection = camera.GetProjection() * camera.GetView();
+        int3 cameraChunkID = ToChunkID(int3(floor(camera.GetPosition())));
+
+        if(m_caveCulling)
+            FindReachableChunks(cameraChunkID);
+
+        for(const ChunkColumn& chunkColumn : m_chunkColumns)
+            for(const Scope<Chunk>& chunk : chunkColumn.GetChunks()) {
+                if(!chunk || !chunk->IsRenderable())
+                    continue;
+
+                m_renderStats.chunkCount++;
+                if(m_caveCulling && !IsReachable(chunk->GetID())) {
+                    m_renderStats.occlusionCulledCount++;
+                    continue;
+                }
+
+                float3 center = float3(chunk->GetID() * Config::CHUNK_SIZE) + halfExtent;
+                m_renderChunks.push_back(chunk.get());
+                m_renderCenterX.push_back(center.x);
+                m_renderCenterY.push_back(center.y);
+                m_renderCenterZ.push_back(center.z);
+            }
+
+        m_renderVisible.assign(m_renderChunks.size(), RenderVisibility::Visible);
+
+        if(m_frustumCulling) {
+            Frustum frustum(viewProjection);
+            std::span<u8> frustumVisible((u8*)m_renderVisible.data(), m_renderVisible.size());
+            if(m_simdCulling)
+                frustum.CullBoxes(m_renderCenterX, m_renderCenterY, m_renderCenterZ, halfExtent, frustumVisible);
+            else
+                frustum.CullBoxesScalar(m_renderCenterX, m_renderCenterY, m_renderCenterZ, halfExtent, frustumVisible);
+        }
+
+        if(m_hiZCulling)
+            CullOccluded(viewProjection, cameraChunkID);
+
+        m_renderStats.cullMicroseconds = duration<f32, std::micro>(high_resolution_clock::now() - cullStart).count();
+
+        bool indirect = m_indirectDrawing && RendererAPI::SupportsIndirectDraw();
+        m_indirectDraws.clear();
+        m_directDraws.clear();
+
+        for(u64 i = 0; i < m_renderChunks.size(); i++) {
+            if(m_renderVisible[i] == RenderVisibility::Culled) {
+                m_renderStats.frustumCulledCount++;
+                continue;
+            }
+
+            if(m_renderVisible[i] == RenderVisibility::Occluded) {
+                m_renderStats.hiZCulledCount++;
+                continue;
+            }
+
+            const Chunk* chunk = m_renderChunks[i];
+            u8 facingMask = m_backfaceCulling ? chunk->GetFacingMask(camera.GetPosition()) : Chunk::ALL_FACINGS;
+
+            if(indirect && chunk->IsInArena())
+                chunk->AddDraws(facingMask, m_indirectDraws);
+            else {
+                m_directDraws.emplace_back(chunk, facingMask);
+                m_renderStats.directDrawCount += chunk->GetDrawCount(facingMask);
+            }
+
+            u32 quadCount = chunk->GetQuadCount(facingMask);
+            m_renderStats.drawnCount++;
+            m_renderStats.drawnQuadCount += quadCount;
+            m_renderStats.backfaceCulledQuadCount += chunk->GetQuadCount() - quadCount;
+        }
+
+        auto recordStart = high_resolution_clock::now();
+
+        // Every arena chunk in a handful of vkCmdDrawIndexedIndirect calls, independent of the chunk count
+        if(!m_indirectDraws.empty())
+            m_renderStats.indirectSliceCount = RendererAPI::DrawQuadsIndirect(GeometryArena::GetBuffer(), m_indirectDraws, m_parallelRecording);
+        m_renderStats.indirectDrawCount = (u32)m_indirectDraws.size();
+
+        auto recordDirect = [this](u32 begin, u32 end) {
+            for(u32 i = begin; i < end; i++)
+                m_directDraws[i].first->Render(m_directDraws[i].second);
+        };
+
+        if(m_parallelRecording)
+            m_renderStats.recordSliceCount = RendererAPI::RecordParallel((u32)m_directDraws.size(), recordDirect);
+        else {
+            recordDirect(0, (u32)m_directDraws.size());
+            m_renderStats.recordSliceCount = 1;
+        }
+
+        m_renderStats.recordMicroseconds = duration<f32, std::micro>(high_resolution_clock::now() - recordStart).count();
+    }
+
+    void World::CullOccluded(const Mat4& viewProjection, int3 cameraChunkID) {
+        m_occlusionBuffer.Begin(viewProjection);
+
+        // Only chunks in the frustum can cover any pixel
+        for(u64 i = 0; i < m_renderChunks.size(); i++) {
+            int3 chunkID = m_renderChunks[i]->GetID();
+            int3 distance = abs(chunkID - cameraChunkID);
+            if(m_renderVisible[i] == RenderVisibility::Visible && std::max({distance.x, distance.y, distance.z}) <= OCCLUDER_DISTANCE)
+                m_renderChunks[i]->GetOccluder().AddTo(m_occlusionBuffer, chunkID * Config::CHUNK_SIZE);
+        }
+
+        m_renderStats.occluderCount = m_occlusionBuffer.GetOccluderCount();
+        if(m_renderStats.occluderCount == 0)
+            return;
+
+        m_occlusionBuffer.Rasterize();
+
+        // A chunk's own occluders lie inside its box, so they can never hide it
+        for(u64 i = 0; i < m_renderChunks.size(); i++) {
+            if(m_renderVisible[i] != RenderVisibility::Visible)
+                continue;
+
+            float3 min = float3(m_renderChunks[i]->GetID() * Config::CHUNK_SIZE);
+            if(!m_occlusionBuffer.IsVisible(min, min + float3(Config::CHUNK_SIZE)))
+                m_renderVisible[i] = RenderVisibility::Occluded;
+        }
+    }
+
+    void World::FindReachableChunks(int3 cameraChunkID) {
+        // Cameras above or below the world start from the closest layer
+        cameraChunkID.y = std::clamp(cameraChunkID.y, 0, (i32)Config::WORLD_SIZE.y - 1);
+
+        m_reachableOrigin = cameraChunkID;
+        m_reachable.assign((u64)REACHABLE_SIZE * REACHABLE_SIZE * Config::WORLD_SIZE.y, 0);
+
+        m_reachFrontier.clear();
+        m_reachFrontier.push_back({cameraChunkID, 6, 0});
+        m_reachable[(u64)((cameraChunkID.y * REACHABLE_SIZE + REACHABLE_RADIUS) * REACHABLE_SIZE + REACHABLE_RADIUS)] = 1;
+
+        // Walked by index, the frontier keeps its capacity across frames
+        for(u64 i = 0; i < m_reachFrontier.size(); i++) {
+            ReachStep step = m_reachFrontier[i];
+
+            // Chunks not loaded or generated yet are treated as open
+            const Chunk* chunk = GetChunk(step.chunkID);
+            ChunkVisibility visibility = chunk ? chunk->GetVisibility() : ChunkVisibility::All();
+
+            for(const Facing& facing : Facing::FACINGS) {
+                if(step.directions >> facing.opposite & 1)
+                    continue;
+
+                if(step.entryFace != 6 && !visibility.IsConnected(step.entryFace, facing.index))
+                    continue;
+
+                int3 nextID = step.chunkID + facing.directionVec;
+                int3 local = nextID - m_reachableOrigin + int3(REACHABLE_RADIUS, 0, REACHABLE_RADIUS);
+                if(local.x < 0 || local.x >= REACHABLE_SIZE ||
+                   local.z < 0 || local.z >= REACHABLE_SIZE ||
+                   nextID.y < 0 || nextID.y >= (i32)Config::WORLD_SIZE.y)
+                    continue;
+
+                u8& reachable = m_reachable[(u64)((nextID.y * REACHABLE_SIZE + local.z) * REACHABLE_SIZE + local.x)];
+                if(reachable)
+                    continue;
+
+                reachable = 1;
+                m_reachFrontier.push_back({nextID, facing.opposite, step.directions | 1u << facing.index});
+            }
+        }
+    }
+
+    bool World::IsReachable(int3 chunkID) const {
+        int3 local = chunkID - m_reachableOrigin + int3(REACHABLE_RADIUS, 0, REACHABLE_RADIUS);
+
+        // Outside the searched area, keep it rather than risk dropping a visible chunk
+        if(local.x < 0 || local.x >= REACHABLE_SIZE ||
+           local.z < 0 || local.z >= REACHABLE_SIZE ||
+           chunkID.y < 0 || chunkID.y >= (i32)Config::WORLD_SIZE.y)
+            return true;
+
+        return m_reachable[(u64)((chunkID.y * REACHABLE_SIZE + local.z) * REACHABLE_SIZE + local.x)];
+    }
+
+    void World::UpdateMesh() {
+        for(ChunkColumn& chunkColumn : m_chunkColumns)
+            chunkColumn.UpdateMesh();
     }
 
     HitInfo World::RayCast(float3 origin, float3 direction, float distance) {
@@ -85,8 +278,8 @@ namespace mc
             }
             
             //Check if ray has hit a wall
-            BlockState* blockState = GetBlockState(blockPos);
-            if (blockState && blockState->GetBlock() != Block::AIR)
+            const BlockState* blockState = GetBlockState(blockPos);
+            if (blockState && !blockState->IsAir())
                 return {true, blockState, blockPos, normal};
         }
         
@@ -94,26 +287,14 @@ namespace mc
     }
 
     Chunk* World::GetChunk(int3 chunkID) {
-        int2 columnID = chunkID.xz;
-        if(!m_chunkColumns.contains(columnID))
-            return nullptr;
-        return m_chunkColumns.at(columnID).GetChunk(chunkID);
+        if(ChunkColumn* column = m_chunkColumns.Find(chunkID.xz))
+            return column->GetChunk(chunkID);
+        return nullptr;
     }
 
     const Chunk* World::GetChunk(int3 chunkID) const {
-        int2 columnID = chunkID.xz;
-        if(!m_chunkColumns.contains(columnID))
-            return nullptr;
-        return m_chunkColumns.at(columnID).GetChunk(chunkID);
-    }
-
-    BlockState* World::GetBlockState(int3 blockPos) {
-        int3 chunkID = ToChunkID(blockPos);
-        int2 columnID = int2(chunkID.xz);
-
-        if(m_chunkColumns.contains(columnID))
-            return m_chunkColumns.at(columnID).GetBlockState(blockPos);
-
+        if(const ChunkColumn* column = m_chunkColumns.Find(chunkID.xz))
+            return column->GetChunk(chunkID);
         return nullptr;
     }
 
@@ -121,8 +302,8 @@ namespace mc
         int3 chunkID = ToChunkID(blockPos);
         int2 columnID = int2(chunkID.xz);
 
-        if(m_chunkColumns.contains(columnID))
-            return m_chunkColumns.at(columnID).GetBlockState(blockPos);
+        if(const ChunkColumn* column = m_chunkColumns.Find(columnID))
+            return column->GetBlockState(blockPos);
 
         return nullptr;
     }
@@ -131,8 +312,8 @@ namespace mc
         int3 chunkID = ToChunkID(blockPos);
         int2 columnID = int2(chunkID.xz);
 
-        if(m_chunkColumns.contains(columnID)) {
-            m_chunkColumns.at(columnID).SetBlockState(blockPos, blockState);
+        if(ChunkColumn* column = m_chunkColumns.Find(columnID)) {
+            column->SetBlockState(blockPos, blockState);
             return;
         }
 
@@ -1,17 +1,48 @@
 ﻿#pragma once
-#include "ChunkColumn.h"
+#include "ChunkColumnMap.h"
 #include "IChunkProvider.h"
 
+#include "MineClone/Core/Renderer/Camera.h"
+#include "MineClone/Core/Renderer/OcclusionBuffer.h"
+
 namespace mc
 {
     struct HitInfo
     {
         bool hit;
-        BlockState* blockState;
+        const BlockState* blockState;
 
         int3 blockPos;
         float3 hitNormal;
     };
+
+    struct RenderStats
+    {
+        // Generated chunks with a non empty mesh
+        u32 chunkCount = 0;
+        u32 drawnCount = 0;
+        u32 frustumCulledCount = 0;
+        // Not reachable from the camera through the chunk visibility graph
+        u32 occlusionCulledCount = 0;
+        // Hidden behind nearby terrain in the software occlusion buffer
+        u32 hiZCulledCount = 0;
+        u32 occluderCount = 0;
+
+        // Quads of drawn chunks submitted vs. skipped because their facing points away from the camera
+        u32 drawnQuadCount = 0;
+        u32 backfaceCulledQuadCount = 0;
+
+        // Quad ranges drawn from the GeometryArena with indirect draws vs. with one draw call each
+        u32 indirectDrawCount = 0;
+        u32 directDrawCount = 0;
+        // Secondary command buffers the direct draws were recorded into, 1 when recorded inline
+        u32 recordSliceCount = 0;
+        // Slices the indirect commands were written in, 1 when written inline
+        u32 indirectSliceCount = 0;
+
+        f32 cullMicroseconds = 0;
+        f32 recordMicroseconds = 0;
+    };
     
     class World final : public IChunkProvider
     {
@@ -28,7 +59,9 @@ namespace mc
     public:
         void Tick();
 
-        void Render();
+        void Render(const Camera& camera);
+        // Remeshes every loaded chunk
+        void UpdateMesh();
 
         HitInfo RayCast(float3 origin, float3 direction, float distance);
         
@@ -36,12 +69,93 @@ namespace mc
         Chunk* GetChunk(int3 chunkID) override;
         const Chunk* GetChunk(int3 chunkID) const override;
         
-        BlockState* GetBlockState(int3 blockPos) override;
         const BlockState* GetBlockState(int3 blockPos) const override;
         void SetBlockState(int3 blockPos, const BlockState& blockState) override;
 
+        const ChunkColumnMap& GetChunkColumns() const { return m_chunkColumns; }
+
+        const RenderStats& GetRenderStats() const { return m_renderStats; }
+
+        bool IsFrustumCulling() const { return m_frustumCulling; }
+        void SetFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+        bool IsSimdCulling() const { return m_simdCulling; }
+        void SetSimdCulling(bool enabled) { m_simdCulling = enabled; }
+        bool IsCaveCulling() const { return m_caveCulling; }
+        void SetCaveCulling(bool enabled) { m_caveCulling = enabled; }
+        bool IsHiZCulling() const { return m_hiZCulling; }
+        void SetHiZCulling(bool enabled) { m_hiZCulling = enabled; }
+        bool IsBackfaceCulling() const { return m_backfaceCulling; }
+        void SetBackfaceCulling(bool enabled) { m_backfaceCulling = enabled; }
+        // Also requires RendererAPI::SupportsIndirectDraw
+        bool IsIndirectDrawing() const { return m_indirectDrawing; }
+        void SetIndirectDrawing(bool enabled) { m_indirectDrawing = enabled; }
+        // Records direct chunk draws and writes the indirect draw commands on the JobSystem,
+        // see RendererAPI::RecordParallel and RendererAPI::DrawQuadsIndirect
+        bool IsParallelRecording() const { return m_parallelRecording; }
+        void SetParallelRecording(bool enabled) { m_parallelRecording = enabled; }
+
+        // Occlusion buffer of the last rendered frame, filled only while hi-Z culling is enabled
+        const OcclusionBuffer& GetOcclusionBuffer() const { return m_occlusionBuffer; }
+
     private:
-        std::unordered_map<int2, ChunkColumn> m_chunkColumns;
+        // Breadth first search from the camera chunk through faces connected by ChunkVisibility,
+        // never stepping back towards the camera. Marks every reached chunk in m_reachable.
+        void FindReachableChunks(int3 cameraChunkID);
+        bool IsReachable(int3 chunkID) const;
+
+        // Rasterizes the chunks close to the camera as occluders and drops the frustum visible chunks hidden behind them
+        void CullOccluded(const Mat4& viewProjection, int3 cameraChunkID);
+
+    private:
+        ChunkColumnMap m_chunkColumns;
+
+        bool m_frustumCulling = true;
+        bool m_simdCulling = true;
+        bool m_caveCulling = true;
+        bool m_hiZCulling = true;
+        bool m_backfaceCulling = true;
+        bool m_indirectDrawing = true;
+        bool m_parallelRecording = true;
+        RenderStats m_renderStats;
+
+        // Chebyshev distance in chunks of the chunks drawn into the occlusion buffer
+        static constexpr i32 OCCLUDER_DISTANCE = 3;
+        OcclusionBuffer m_occlusionBuffer;
+
+        // Chunks around the camera chunk, all loaded chunks are within the delete distance
+        static constexpr i32 REACHABLE_RADIUS = Config::DELETE_DISTANCE;
+        static constexpr i32 REACHABLE_SIZE = REACHABLE_RADIUS * 2 + 1;
+
+        struct ReachStep
+        {
+            int3 chunkID;
+            // Face the chunk was entered through, 6 for the camera chunk
+            u32 entryFace;
+            // Directions taken since leaving the camera chunk
+            u32 directions;
+        };
+
+        int3 m_reachableOrigin{};
+        std::vector<u8> m_reachable;
+        std::vector<ReachStep> m_reachFrontier;
+
+        // Culled and Visible are the 0 and 1 Frustum::CullBoxes writes
+        enum class RenderVisibility : u8
+        {
+            Culled,
+            Visible,
+            // Inside the frustum but hidden in the occlusion buffer
+            Occluded,
+        };
+
+        // Render scratch buffers, chunk centers are kept SoA for the SIMD frustum test
+        std::vector<const Chunk*> m_renderChunks;
+        std::vector<f32> m_renderCenterX;
+        std::vector<f32> m_renderCenterY;
+        std::vector<f32> m_renderCenterZ;
+        std::vector<RenderVisibility> m_renderVisible;
+        std::vector<QuadDraw> m_indirectDraws;
+        std::vector<std::pair<const Chunk*, u8>> m_directDraws;
 
         friend class ChunkManager;
         friend class ChunkGenerator;
@@ -1,8 +1,25 @@
 #include "mcpch.h"
 
 #include "MineClone/Application.h"
+#include "MineClone/Benchmark/ChunkColumnMapBenchmark.h"
+#include "MineClone/Benchmark/OcclusionBufferBenchmark.h"
+#include "MineClone/Benchmark/RenderBenchmark.h"
 
 int main(int argc, char* argv[]) {
+    std::vector<std::string_view> args{argv + 1, argv + argc};
+    if(std::ranges::find(args, "--bench-column-map") != args.end()) {
+        mc::ChunkColumnMapBenchmark::Run();
+        return 0;
+    }
+    if(std::ranges::find(args, "--bench-hiz") != args.end()) {
+        mc::OcclusionBufferBenchmark::Run();
+        return 0;
+    }
+    if(std::ranges::find(args, "--bench-render") != args.end()) {
+        mc::RenderBenchmark::Run(args);
+        return 0;
+    }
+
     // try {
         mc::Application* app = new mc::Application("MineClone");
         app->Run();
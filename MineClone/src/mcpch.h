@@ -21,6 +21,7 @@
 #include <deque>
 
 // Others
+#include <bit>
 #include <memory>
 #include <ranges>
 #include <chrono>
@@ -1,8 +1,9 @@
 #version 450
 
 layout(location = 0) in vec3 inNormal;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inUV;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) flat in vec2 inTileOrigin;
+layout(location = 3) in float inShade;
 
 layout(binding = 1) uniform sampler2D texSampler;
 
@@ -10,13 +11,19 @@ layout(location = 0) out vec4 outColor;
 
 vec3 lightDir = vec3(-1, 2, 1);
 
+// Size of one atlas tile, matches Config::ATLAS_ELEMENT_SIZE
+const vec2 TILE_SIZE = vec2(1.0 / 16.0);
+
 float map(float value, float min1, float max1, float min2, float max2) {
     return min2 + (value - min1) * (max2 - min2) / (max1 - min1);
 }
 
 void main() {
-    outColor = texture(texSampler, inUV) * vec4(inColor, 1);
+    // Merged quads span several blocks, repeat the tile inside the atlas
+    // Gradients come from the continuous uv so fract does not break them at tile edges
+    vec2 atlasUV = inTileOrigin + fract(inUV) * TILE_SIZE;
+    outColor = textureGrad(texSampler, atlasUV, dFdx(inUV) * TILE_SIZE, dFdy(inUV) * TILE_SIZE);
     //outColor = vec4(inUV, 0, 1);
 
-    outColor.rgb *= dot(normalize(inNormal), lightDir) / 4 + .75;
+    outColor.rgb *= (dot(normalize(inNormal), lightDir) / 4 + .75) * inShade;
 }
\ No newline at end of file
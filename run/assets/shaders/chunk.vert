@@ -4,24 +4,65 @@ layout(binding = 0) uniform UBO {
     vec4 data;
     mat4 proj;
     mat4 view;
+    mat4 viewProj;
 } ubo;
 
+// ChunkPushConstants, zero for indirect draws
 layout(push_constant) uniform PushConstants {
-    mat4 model;
+    vec3 origin;
 } pushConstants;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inColor;
-layout(location = 3) in vec2 inUV;
+// Origin of every indirect draw, selected through its firstInstance. Entry 0 is zero for direct draws.
+layout(std430, binding = 2) readonly buffer DrawData {
+    vec4 origins[];
+} drawData;
+
+// Packed ChunkVertex, see Config.h
+layout(location = 0) in uvec2 inData;
 
 layout(location = 0) out vec3 outNormal;
-layout(location = 1) out vec3 outColor;
-layout(location = 2) out vec2 outUV;
+layout(location = 1) out vec2 outUV;
+layout(location = 2) flat out vec2 outTileOrigin;
+layout(location = 3) out float outShade;
+
+// Indexed by Facing
+const vec3 NORMALS[6] = vec3[](
+    vec3( 0,  1,  0),
+    vec3( 0, -1,  0),
+    vec3( 0,  0,  1),
+    vec3( 0,  0, -1),
+    vec3( 1,  0,  0),
+    vec3(-1,  0,  0)
+);
+
+// Must match Config::ATLAS_SIZE
+const uint ATLAS_SIZE = 16u;
+
+// Texture coordinates in blocks, oriented like Config::VERTICES so the tile repeats across merged quads
+vec2 FaceUV(uint face, vec3 position) {
+    switch(face) {
+    case 0: return vec2( position.x, -position.z);
+    case 1: return vec2( position.x,  position.z);
+    case 2: return vec2( position.x,  position.y);
+    case 3: return vec2(-position.x,  position.y);
+    case 4: return vec2(-position.z,  position.y);
+    default: return vec2( position.z,  position.y);
+    }
+}
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * pushConstants.model * vec4(inPosition, 1.0);
-    outNormal = inNormal * inverse(mat3(pushConstants.model));
-    outColor = inColor;
-    outUV = inUV; 
+    uint data = inData.x;
+    vec3 position = vec3(data & 31u, (data >> 5) & 31u, (data >> 10) & 31u);
+    uint face = (data >> 15) & 7u;
+    uint ao = (data >> 20) & 3u;
+    uint light = (data >> 22) & 15u;
+    uint tile = inData.y;
+
+    vec3 origin = pushConstants.origin + drawData.origins[gl_InstanceIndex].xyz;
+
+    gl_Position = ubo.viewProj * vec4(origin + position, 1.0);
+    outNormal = NORMALS[face];
+    outUV = FaceUV(face, position);
+    outTileOrigin = vec2(tile % ATLAS_SIZE, ATLAS_SIZE - 1u - tile / ATLAS_SIZE) / float(ATLAS_SIZE);
+    outShade = (0.5 + 0.5 * float(ao) / 3.0) * float(light) / 15.0;
 }
\ No newline at end of file
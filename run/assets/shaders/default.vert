@@ -4,6 +4,7 @@ layout(binding = 0) uniform UBO {
     vec4 data;
     mat4 proj;
     mat4 view;
+    mat4 viewProj;
 } ubo;
 
 layout(push_constant) uniform PushConstants {
@@ -20,7 +21,7 @@ layout(location = 1) out vec3 outColor;
 layout(location = 2) out vec2 outUV;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * pushConstants.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.viewProj * pushConstants.model * vec4(inPosition, 1.0);
     outNormal = inNormal * inverse(mat3(pushConstants.model));
     outColor = inColor;
     outUV = inUV; 